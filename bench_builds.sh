@@ -0,0 +1,45 @@
+#!/bin/sh
+# Compila o programa em cada modo (sem otimização, como o comando antigo do
+# README; Release -O3 -march=native; + LTO; + PGO treinado no caminho de
+# câmera do benchmark) e compara o rasterizador em software e o grafo de cena.
+#   ./bench_builds.sh            # 60 quadros por modo
+#   FRAMES=200 ./bench_builds.sh
+set -e
+cd "$(dirname "$0")"
+FRAMES=${FRAMES:-60}
+ARGS="--headless=$FRAMES --size=640x480 --seed=1"
+BUILD=_bench_builds
+JOBS=$(nproc 2>/dev/null || echo 2)
+
+build() {   # build <dir> <opções do cmake>
+    dir=$BUILD/$1
+    shift
+    cmake -S . -B "$dir" "$@" -DSOLAR_TRAIN_ARGS="$(echo $ARGS | tr ' ' ';')" > "$dir.log" 2>&1 || { cat "$dir.log"; exit 1; }
+    cmake --build "$dir" -j"$JOBS" --target solar >> "$dir.log" 2>&1 || { cat "$dir.log"; exit 1; }
+}
+
+measure() {   # measure <dir> -> "ms_quadro ms_grafo"
+    frame=$("$BUILD/$1/solar" $ARGS | sed -n 's/^Software.*: \([0-9.]*\) ms\/quadro.*/\1/p')
+    graph=$("$BUILD/$1/solar" --bench-graph | sed -n 's/^  tudo mudando: *\([0-9.]*\) ms.*/\1/p')
+    echo "$frame $graph"
+}
+
+mkdir -p $BUILD
+echo "Compilando..."
+build sem-otimizacao -DCMAKE_BUILD_TYPE=None -DSOLAR_NATIVE=OFF -DSOLAR_LTO=OFF
+build release -DCMAKE_BUILD_TYPE=Release -DSOLAR_LTO=OFF
+build lto -DCMAKE_BUILD_TYPE=Release -DSOLAR_LTO=ON
+build pgo -DCMAKE_BUILD_TYPE=Release -DSOLAR_LTO=ON -DSOLAR_PGO=generate
+echo "Treinando o PGO..."
+cmake --build $BUILD/pgo --target pgo-train >> $BUILD/pgo.log 2>&1
+build pgo -DSOLAR_PGO=use
+
+echo "Benchmark: $ARGS (software) e --bench-graph (100000 nos, tudo mudando)"
+printf "  %-16s %12s %8s %12s %8s\n" modo "ms/quadro" ganho "ms/grafo" ganho
+base=""
+for mode in sem-otimizacao release lto pgo; do
+    set -- $(measure $mode)
+    [ -z "$base" ] && { base_frame=$1; base_graph=$2; base=1; }
+    awk -v m=$mode -v f="$1" -v g="$2" -v bf=$base_frame -v bg=$base_graph \
+        'BEGIN { printf "  %-16s %12.2f %7.2fx %12.2f %7.2fx\n", m, f, bf / f, g, bg / g }'
+done
@@ -0,0 +1,59 @@
+#!/bin/sh
+# Tempo de recompilação depois de editar um arquivo, com o programa em módulos
+# (src/*.cpp, stb_image num TU próprio) e com tudo num só TU, como era o
+# solar.cpp antigo (CMAKE_UNITY_BUILD; cada edição recompila também o stb_image,
+# que ficava dentro dele). Os dois sem LTO; a última coluna mostra o custo do
+# link com LTO, que reotimiza o programa inteiro a cada edição.
+#   ./bench_rebuild.sh
+set -e
+cd "$(dirname "$0")"
+BUILD=_bench_rebuild
+JOBS=$(nproc 2>/dev/null || echo 2)
+
+configure() {   # configure <dir> <opções do cmake>
+    dir=$BUILD/$1
+    shift
+    cmake -S . -B "$dir" -DCMAKE_BUILD_TYPE=Release "$@" > "$dir.log" 2>&1 || { cat "$dir.log"; exit 1; }
+}
+
+elapsed() {   # elapsed <comando...> -> segundos
+    begin=$(date +%s%N)
+    "$@" >> "$BUILD/tempos.log" 2>&1
+    awk -v a="$begin" -v b="$(date +%s%N)" 'BEGIN { printf "%.1f", (b - a) / 1e9 }'
+}
+
+rebuild() {   # rebuild <dir> <arquivo editado> -> segundos
+    if [ "$1" = um-tu ]; then
+        touch src/stb_image.cpp
+    else                # o stb tocado pelo um-tu não entra na conta dos módulos
+        cmake --build "$BUILD/$1" -j"$JOBS" --target stb_image >> "$BUILD/tempos.log" 2>&1
+    fi
+    touch "$2"
+    elapsed cmake --build "$BUILD/$1" -j"$JOBS" --target solar
+}
+
+mkdir -p $BUILD
+: > $BUILD/tempos.log
+echo "Configurando..."
+configure um-tu -DSOLAR_LTO=OFF -DCMAKE_UNITY_BUILD=ON -DCMAKE_UNITY_BUILD_BATCH_SIZE=0
+configure modulos -DSOLAR_LTO=OFF
+configure modulos-lto -DSOLAR_LTO=ON
+
+echo "Recompilacao do alvo solar ($JOBS jobs), em segundos:"
+printf "  %-34s %12s %12s %12s\n" "" um-tu modulos modulos+lto
+for mode in um-tu modulos modulos-lto; do
+    cmake --build "$BUILD/$mode" --target clean > /dev/null
+done
+printf "  %-34s" "do zero"
+for mode in um-tu modulos modulos-lto; do printf " %12s" "$(elapsed cmake --build "$BUILD/$mode" -j"$JOBS" --target solar)"; done
+echo
+for edit in src/camera.cpp src/stars.h src/bodies.h src/common.h; do
+    case $edit in
+        *.cpp)         what="um modulo ($edit)" ;;
+        src/common.h)  what="header de todos ($edit)" ;;
+        *)             what="header ($edit)" ;;
+    esac
+    printf "  %-34s" "$what"
+    for mode in um-tu modulos modulos-lto; do printf " %12s" "$(rebuild $mode $edit)"; done
+    echo
+done
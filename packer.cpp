@@ -0,0 +1,216 @@
+// Empacotador de texturas: converte as imagens de uma pasta em um único
+// arquivo (textures.pack) com índice, cadeias de mipmaps prontas e checksums.
+//
+// Uso:
+//   g++ -O2 -I. packer.cpp src/stb_image.cpp -o packer   (ou o alvo packer do CMake)
+//   ./packer [--dxt1] textures textures.pack
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "stb_image.h"
+
+#include "texpack.h"
+
+struct Image {
+    int w, h;
+    std::vector<unsigned char> rgba;
+};
+
+// Reduz a imagem pela metade (filtro de caixa 2x2; bordas ímpares repetem o último texel)
+static Image downsample(const Image& src) {
+    Image dst;
+    dst.w = src.w > 1 ? src.w / 2 : 1;
+    dst.h = src.h > 1 ? src.h / 2 : 1;
+    dst.rgba.resize((size_t)dst.w * dst.h * 4);
+    for (int y = 0; y < dst.h; ++y) {
+        int y0 = std::min(2 * y, src.h - 1), y1 = std::min(2 * y + 1, src.h - 1);
+        for (int x = 0; x < dst.w; ++x) {
+            int x0 = std::min(2 * x, src.w - 1), x1 = std::min(2 * x + 1, src.w - 1);
+            for (int c = 0; c < 4; ++c) {
+                int s = src.rgba[((size_t)y0 * src.w + x0) * 4 + c] + src.rgba[((size_t)y0 * src.w + x1) * 4 + c]
+                      + src.rgba[((size_t)y1 * src.w + x0) * 4 + c] + src.rgba[((size_t)y1 * src.w + x1) * 4 + c];
+                dst.rgba[((size_t)y * dst.w + x) * 4 + c] = (unsigned char)((s + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+static unsigned short to565(int r, int g, int b) {
+    return (unsigned short)(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+static void from565(unsigned short c, int out[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// Compressão DXT1 simples: extremos pela caixa envolvente de cada bloco 4x4
+static std::vector<unsigned char> encodeDXT1(const Image& img) {
+    int bw = (img.w + 3) / 4, bh = (img.h + 3) / 4;
+    std::vector<unsigned char> out((size_t)bw * bh * 8);
+    unsigned char* dst = out.data();
+    for (int by = 0; by < bh; ++by) {
+        for (int bx = 0; bx < bw; ++bx) {
+            int px[16][3];
+            int lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0};
+            for (int i = 0; i < 16; ++i) {
+                int x = std::min(bx * 4 + (i & 3), img.w - 1);
+                int y = std::min(by * 4 + (i >> 2), img.h - 1);
+                const unsigned char* p = &img.rgba[((size_t)y * img.w + x) * 4];
+                for (int c = 0; c < 3; ++c) {
+                    px[i][c] = p[c];
+                    lo[c] = std::min(lo[c], (int)p[c]);
+                    hi[c] = std::max(hi[c], (int)p[c]);
+                }
+            }
+            unsigned short c0 = to565(hi[0], hi[1], hi[2]);
+            unsigned short c1 = to565(lo[0], lo[1], lo[2]);
+            if (c0 < c1) std::swap(c0, c1);
+
+            unsigned int indices = 0;
+            if (c0 != c1) {                       // modo de 4 cores (c0 > c1)
+                int pal[4][3];
+                from565(c0, pal[0]);
+                from565(c1, pal[1]);
+                for (int c = 0; c < 3; ++c) {
+                    pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+                    pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+                }
+                for (int i = 0; i < 16; ++i) {
+                    int best = 0, bestDist = 1 << 30;
+                    for (int k = 0; k < 4; ++k) {
+                        int dr = px[i][0] - pal[k][0], dg = px[i][1] - pal[k][1], db = px[i][2] - pal[k][2];
+                        int d = dr * dr + dg * dg + db * db;
+                        if (d < bestDist) { bestDist = d; best = k; }
+                    }
+                    indices |= (unsigned int)best << (2 * i);
+                }
+            }
+            dst[0] = c0 & 0xFF; dst[1] = c0 >> 8;
+            dst[2] = c1 & 0xFF; dst[3] = c1 >> 8;
+            dst[4] = indices & 0xFF;         dst[5] = (indices >> 8) & 0xFF;
+            dst[6] = (indices >> 16) & 0xFF; dst[7] = indices >> 24;
+            dst += 8;
+        }
+    }
+    return out;
+}
+
+static bool hasImageExtension(const std::string& f) {
+    size_t dot = f.rfind('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = f.substr(dot);
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png";
+}
+
+int main(int argc, char** argv) {
+    uint32_t format = PACK_RGBA8;
+    const char* dir = NULL;
+    const char* outPath = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--dxt1") == 0) format = PACK_DXT1;
+        else if (!dir) dir = argv[i];
+        else if (!outPath) outPath = argv[i];
+    }
+    if (!dir || !outPath) {
+        fprintf(stderr, "Uso: %s [--dxt1] <pasta_texturas> <saida.pack>\n", argv[0]);
+        return 1;
+    }
+
+    // Lista as imagens da pasta (ordenadas, para um pacote determinístico)
+    std::vector<std::string> files;
+    DIR* d = opendir(dir);
+    if (!d) { fprintf(stderr, "Erro ao abrir pasta: %s\n", dir); return 1; }
+    while (dirent* e = readdir(d))
+        if (hasImageExtension(e->d_name)) files.push_back(e->d_name);
+    closedir(d);
+    std::sort(files.begin(), files.end());
+    if (files.empty()) { fprintf(stderr, "Nenhuma imagem em %s\n", dir); return 1; }
+
+    std::vector<PackEntry> entries(files.size());
+    std::vector<std::vector<unsigned char> > blobs;   // dados de todos os mips, na ordem do arquivo
+
+    size_t dataStart = sizeof(PackHeader) + sizeof(PackEntry) * entries.size();
+    uint64_t offset = (dataStart + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN;
+
+    stbi_set_flip_vertically_on_load(1);    // mesma orientação usada pelo programa
+    for (size_t f = 0; f < files.size(); ++f) {
+        std::string path = std::string(dir) + "/" + files[f];
+        Image img;
+        int n;
+        unsigned char* data = stbi_load(path.c_str(), &img.w, &img.h, &n, 4);
+        if (!data) { fprintf(stderr, "Erro ao carregar textura: %s\n", path.c_str()); return 1; }
+        img.rgba.assign(data, data + (size_t)img.w * img.h * 4);
+        stbi_image_free(data);
+        if ((uint32_t)img.w > PACK_MAX_SIZE || (uint32_t)img.h > PACK_MAX_SIZE) {
+            fprintf(stderr, "Erro: %s maior que %ux%u\n", path.c_str(), PACK_MAX_SIZE, PACK_MAX_SIZE);
+            return 1;
+        }
+
+        PackEntry& e = entries[f];
+        memset(&e, 0, sizeof(e));
+        std::string name = files[f].substr(0, files[f].rfind('.'));
+        strncpy(e.name, name.c_str(), sizeof(e.name) - 1);
+        e.width = img.w;
+        e.height = img.h;
+        e.format = format;
+
+        // Cadeia completa de mipmaps (até 1x1)
+        uint64_t checksum = 0xcbf29ce484222325ULL;
+        for (int level = 0; level < PACK_MAX_MIPS; ++level) {
+            std::vector<unsigned char> mip = (format == PACK_DXT1) ? encodeDXT1(img) : img.rgba;
+            e.mipOffset[level] = offset;
+            e.mipSize[level] = packMipSize(format, img.w, img.h);
+            if (e.mipSize[level] != mip.size()) {
+                fprintf(stderr, "Erro: mip %d de %s com %zu bytes (esperado %u)\n", level, path.c_str(), mip.size(), e.mipSize[level]);
+                return 1;
+            }
+            e.mipCount = level + 1;
+            checksum = packChecksum(mip.data(), mip.size(), checksum);
+            offset += (mip.size() + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN;
+            blobs.push_back(mip);
+            if (img.w == 1 && img.h == 1) break;
+            img = downsample(img);
+        }
+        e.checksum = checksum;
+        printf("%-10s %4ux%-4u %2u mips\n", e.name, e.width, e.height, e.mipCount);
+    }
+
+    PackHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = PACK_MAGIC;
+    hdr.version = PACK_VERSION;
+    hdr.count = (uint32_t)entries.size();
+    hdr.indexChecksum = packChecksum(entries.data(), sizeof(PackEntry) * entries.size());
+
+    FILE* out = fopen(outPath, "wb");
+    if (!out) { fprintf(stderr, "Erro ao criar %s\n", outPath); return 1; }
+    fwrite(&hdr, sizeof(hdr), 1, out);
+    fwrite(entries.data(), sizeof(PackEntry), entries.size(), out);
+
+    // Dados: cada mip começa num múltiplo de PACK_ALIGN
+    static const unsigned char zeros[PACK_ALIGN] = {0};
+    size_t blob = 0;
+    for (size_t f = 0; f < entries.size(); ++f) {
+        for (uint32_t level = 0; level < entries[f].mipCount; ++level, ++blob) {
+            long pos = ftell(out);
+            fwrite(zeros, 1, entries[f].mipOffset[level] - pos, out);
+            fwrite(blobs[blob].data(), 1, blobs[blob].size(), out);
+        }
+    }
+    long total = ftell(out);
+    fwrite(zeros, 1, (PACK_ALIGN - total % PACK_ALIGN) % PACK_ALIGN, out);
+    fclose(out);
+
+    printf("Pacote gerado: %s (%zu texturas, %.1f MB, %s)\n", outPath, entries.size(),
+           total / (1024.0 * 1024.0), format == PACK_DXT1 ? "DXT1" : "RGBA8");
+    return 0;
+}
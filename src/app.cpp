@@ -0,0 +1,881 @@
+#include "app.h"
+
+#include <time.h>
+#include <execinfo.h>
+#include <dirent.h>
+#ifdef SOLAR_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include "atmosphere.h"
+#include "belts.h"
+#include "bodies.h"
+#include "camera.h"
+#include "comets.h"
+#include "decode.h"
+#include "hdr.h"
+#include "raytrace.h"
+#include "render.h"
+#include "runtime.h"
+#include "shadows.h"
+#include "software.h"
+#include "stars.h"
+#include "texture.h"
+#include "video.h"
+
+// Estado geral
+unsigned long long simSteps = 0;
+double t = 0.0;
+bool paused = false;
+bool showOrbits = false;
+int winWidth = 1000, winHeight = 800;
+unsigned long simTick = 0;             // quantos ticks de update() já rodaram
+bool fastStart = false;                // --fast-start: primeiro quadro antes das texturas
+bool firstFrameDone = false;
+
+// Gravação e replay de sessões: log binário compacto com a seed e as teclas
+// pressionadas, cada uma marcada com o tick da simulação em que foi aplicada.
+// Como update() avança um passo fixo por tick, reaplicar as mesmas teclas nos
+// mesmos ticks reproduz a sessão exatamente. As opções que mudam o estado
+// vão no cabeçalho e, no replay, valem no lugar das da linha de comando.
+//   cabeçalho: magic "SSRP", versão, seed, cometas, cinturão, escala real,
+//              modo e corpo da câmera, vistas, depth, largura, altura (uint32 cada)
+//   eventos:   delta de ticks (varint) + tecla (1 byte); tecla 0 = fim da sessão
+// As teclas que só gravam arquivos (R, P, V, T) não entram no log.
+const uint32_t REPLAY_MAGIC   = 0x50525353;   // "SSRP"
+const uint32_t REPLAY_VERSION = 2;            // 1 = só a seed no cabeçalho
+const int      REPLAY_HEADER  = 12;
+
+struct ReplayEvent {
+    unsigned long tick;
+    unsigned char key;
+};
+
+FILE* recordFile = NULL;                 // --record=arquivo.rep
+unsigned long recordLastTick = 0;
+std::vector<ReplayEvent> replayEvents;   // --replay=arquivo.rep
+size_t replayNext = 0;
+bool replaying = false;
+std::vector<float> replayFrameMs;        // tempo de cada display() durante o replay
+
+void writeVarint(FILE* f, unsigned long v) {
+    while (v >= 0x80) { fputc((int)(v & 0x7F) | 0x80, f); v >>= 7; }
+    fputc((int)v, f);
+}
+
+bool readVarint(FILE* f, unsigned long* v) {
+    *v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) return false;
+        *v |= (unsigned long)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+void recordEvent(unsigned char key) {
+    if (!recordFile) return;
+    writeVarint(recordFile, simTick - recordLastTick);
+    fputc(key, recordFile);
+    fflush(recordFile);                  // a janela pode ser fechada a qualquer momento
+    recordLastTick = simTick;
+}
+
+void finishRecording() {
+    if (!recordFile) return;
+    recordEvent(0);
+    fclose(recordFile);
+    recordFile = NULL;
+}
+
+// Teclas de saída (imagens, vídeo, trace): não mudam a sessão, e no replay
+// sobrescreveriam arquivos ou abririam uma gravação
+bool isOutputKey(unsigned char key) {
+    return key == 'R' || key == 'P' || key == 'V' || key == 'T';
+}
+
+bool startRecording(const char* path) {
+    recordFile = fopen(path, "wb");
+    if (!recordFile) { printf("Erro ao criar %s\n", path); return false; }
+    uint32_t hdr[REPLAY_HEADER] = {REPLAY_MAGIC, REPLAY_VERSION, starSeed, (uint32_t)cometCount,
+                                   (uint32_t)beltParticles, trueScale, (uint32_t)camMode, (uint32_t)camTarget,
+                                   (uint32_t)viewLayout, (uint32_t)depthMode, (uint32_t)winWidth, (uint32_t)winHeight};
+    fwrite(hdr, sizeof(hdr), 1, recordFile);
+    atexit(finishRecording);             // glutMainLoop só termina via exit()
+    return true;
+}
+
+bool loadReplay(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { printf("Erro ao abrir %s\n", path); return false; }
+    uint32_t hdr[REPLAY_HEADER];
+    bool ok = fread(hdr, sizeof(uint32_t), 3, f) == 3 && hdr[0] == REPLAY_MAGIC &&
+              (hdr[1] == 1 || hdr[1] == REPLAY_VERSION);
+    if (ok && hdr[1] == REPLAY_VERSION) {
+        ok = fread(hdr + 3, sizeof(uint32_t), REPLAY_HEADER - 3, f) == REPLAY_HEADER - 3 &&
+             (int)hdr[3] >= 0 && (int)hdr[4] >= 0 && hdr[5] <= 1 && hdr[6] < (uint32_t)CAM_MODES &&
+             hdr[7] < (uint32_t)NUM_BODIES && hdr[8] < (uint32_t)VIEW_LAYOUTS &&
+             (int)hdr[9] >= -1 && (int)hdr[9] < DEPTH_MODES && (int)hdr[10] > 0 && (int)hdr[11] > 0;
+    }
+    if (!ok) {
+        printf("Replay invalido: %s\n", path);
+        fclose(f);
+        return false;
+    }
+    starSeed = hdr[2];
+    if (hdr[1] == REPLAY_VERSION) {
+        cometCount = (int)hdr[3];
+        beltParticles = (int)hdr[4];
+        trueScale = hdr[5] != 0;
+        camMode = (int)hdr[6];
+        camTarget = (int)hdr[7];
+        viewLayout = (int)hdr[8];
+        depthMode = (int)hdr[9];
+        winWidth = (int)hdr[10];
+        winHeight = (int)hdr[11];
+    }
+    unsigned long tick = 0, delta;
+    int key;
+    while (readVarint(f, &delta) && (key = fgetc(f)) != EOF) {
+        tick += delta;
+        replayEvents.push_back({tick, (unsigned char)key});
+        if (key == 0) break;
+    }
+    fclose(f);
+    if (replayEvents.empty() || replayEvents.back().key != 0)
+        replayEvents.push_back({tick, 0});   // gravação interrompida: termina no último evento
+    replaying = true;
+    printf("Replay: %zu eventos, %lu ticks, seed %u\n", replayEvents.size() - 1, tick, starSeed);
+    return true;
+}
+
+// Fim do replay: estatísticas de tempo de quadro para comparar execuções
+void finishReplay() {
+    std::vector<float> ms = replayFrameMs;
+    double sum = 0.0;
+    for (size_t i = 0; i < ms.size(); ++i) sum += ms[i];
+    std::sort(ms.begin(), ms.end());
+    if (!ms.empty())
+        printf("Replay concluido: %zu quadros, media %.2f ms, p50 %.2f ms, p95 %.2f ms, max %.2f ms\n",
+               ms.size(), sum / ms.size(), ms[ms.size() / 2], ms[ms.size() * 95 / 100], ms.back());
+    exit(0);
+}
+
+// --bench=N: mede N quadros no OpenGL e N no rasterizador em software
+int benchFrames = 0;
+int benchCount = 0;
+double benchTotal[2] = {0.0, 0.0};      // [0] = OpenGL, [1] = software
+
+void benchFrame(double ms) {
+    benchTotal[softwareBackend] += ms;
+    if (++benchCount < benchFrames) return;
+    benchCount = 0;
+    if (!softwareBackend) {
+        softwareBackend = true;
+        return;
+    }
+    printf("Benchmark (%d quadros, %dx%d):\n", benchFrames, winWidth, winHeight);
+    printf("  OpenGL (%s): %.2f ms/quadro\n", (const char*)glGetString(GL_RENDERER), benchTotal[0] / benchFrames);
+    for (int p = 0; p < GPU_PASSES; ++p)
+        if (gpuTimers.samples[p])
+            printf("    %s: %.2f ms/quadro\n", gpuPassNames[p], gpuTimers.totalMs[p] / gpuTimers.samples[p]);
+    if (cometSteps)
+        printf("  CPU: cometas: %.3f ms/passo (%d cometas, %d particulas no pool de %d)\n",
+               cometStepMs / cometSteps, cometCount, cometLive, COMET_POOL);
+    printf("  software (%d threads): %.2f ms/quadro\n", poolThreads(), benchTotal[1] / benchFrames);
+    printf("  arena do quadro: pico %.1f KB de %.1f KB, %lu idas ao heap\n",
+           frameArena.peak / 1024.0, frameArena.capacity / 1024.0, frameArena.heapAllocs);
+    exit(0);
+}
+
+// Contadores de depuração: passado o aquecimento, um quadro em que a arena ou
+// o pool de pedidos de textura foram ao heap é avisado (uma vez)
+const unsigned long STEADY_STATE_FRAMES = 120;
+
+void checkFrameAllocs() {
+    static unsigned long lastArena = 0, lastPool = 0;
+    static bool warned = false;
+    unsigned long arena = frameArena.heapAllocs, pool = uploader.jobPool.heapAllocs;
+    if (!warned && frameArena.frames > STEADY_STATE_FRAMES && (arena != lastArena || pool != lastPool)) {
+        printf("Aviso: o quadro %lu alocou no heap em regime estavel (arena: %lu, pool: %lu)\n",
+               frameArena.frames, arena - lastArena, pool - lastPool);
+        warned = true;
+    }
+    lastArena = arena;
+    lastPool = pool;
+}
+
+// O quadro de display() sem a troca de buffers (também o do --check-allocs no GL)
+void drawFrame() {
+    arenaReset();
+    if (softwareBackend) {
+        renderSoftware(winWidth, winHeight);
+        presentSoftwareFrame();
+    } else {
+        renderSceneGL();
+    }
+    if (video.path && !video.started) startVideo();
+    captureVideoFrame();
+}
+
+void display() {
+    TRACE_SCOPE("display");
+    double frameBegin = nowMs();
+    drawFrame();
+
+    {
+        TRACE_SCOPE("swap");
+        glutSwapBuffers();
+    }
+    if (benchFrames) {
+        glFinish();                         // mede o quadro inteiro, não só o envio
+        benchFrame(nowMs() - frameBegin);
+    }
+    if (replaying) replayFrameMs.push_back((float)(nowMs() - frameBegin));
+    checkFrameAllocs();
+
+    if (!firstFrameDone) {                  // fim da inicialização: primeiro quadro na tela
+        glFinish();
+        startupPhase(NULL);
+        firstFrameDone = true;
+        if (fastStart) printStartupReport();
+        else finishStartupTrace();
+    }
+}
+
+void reshape(int w,int h){
+    winWidth = w;
+    winHeight = h > 0 ? h : 1;
+    glViewport(0,0,w,h);
+    setPerspective(60.0f, (float)w/winHeight);
+}
+
+void init(){
+    glClearColor(0,0,0,0);        // cor do fundo (preto)
+    glEnable(GL_DEPTH_TEST);      // habilita teste de profundidade (oclusão correta)
+
+    // Combine textura com iluminação (textura * luz) e normaliza normais ao escalar
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnable(GL_NORMALIZE);
+
+    // Céu (gera estrelas)
+    startupPhase("estrelas");
+    initStars();
+    initOrbits();
+
+    // Texturas (pacote mapeado ou arquivos soltos; clamp no Sol evita halo da borda)
+    startupPhase("texturas");
+    if (coldStart) evictTextureFiles();
+    double t0 = nowMs();
+    bool fromPack = usePack && openTexturePack("textures.pack");
+    if (fastStart) {              // carregadas depois do primeiro quadro (updateDeferredTextures)
+        deferredTexture = 0;
+        return;
+    }
+    sunTexture = loadNamedTexture("sun", true);
+    for (int i = 0; i < 8; ++i)
+        planetTextures[i] = loadNamedTexture(planetNames[i]);
+    glFinish();                   // inclui o tempo de upload do driver na medição
+    if (fromPack) {
+        printf("Texturas: %.1f ms (textures.pack, %.0f%% ja em cache -> partida %s)\n",
+               nowMs() - t0, 100.0f * texPack.residentBefore,
+               texPack.residentBefore > 0.9f ? "quente" : "fria");
+        closeTexturePack();
+    } else {
+        printf("Texturas: %.1f ms (arquivos soltos%s)\n", nowMs() - t0, coldStart ? ", page cache esvaziado" : "");
+    }
+}
+
+// Um passo fixo da simulação (um tick do timer)
+void stepSimulation() {
+    simSteps++;
+    t = simSteps * SIM_DT;                                   // avança tempo (animações)
+    camAngle = (float)wrapPeriod(simSteps * 0.002, 2 * M_PI);  // gira câmera lentamente
+    stepComets();
+}
+
+// Tudo o que precisa do contexto GL, na ordem do main()
+void initGraphics() {
+    init();                                                  // estados iniciais (texturas/estrelas)
+    startupPhase("iluminacao");
+    initLighting();
+    initDepthMode();
+    startupPhase("atmosfera");
+    initAtmosphere();
+    startupPhase("sombras");
+    initShadows();
+    startupPhase("hdr");
+    initHdr();
+    startupPhase("cinturoes");
+    initBelts();
+    initGpuTimers();
+}
+
+// Aplica uma tecla ao estado (teclado ao vivo ou evento do replay)
+void applyKey(unsigned char key) {
+    switch(key) {
+        case 'Z': case 'z': case 'w': case 's': case 'a': case 'd':
+            cameraKey(key); break;                 // movimento da câmera (depende do modo)
+        case 'c': setCameraMode((camMode + 1) % CAM_MODES);   // órbita/perseguição/superfície/livre
+            printf("Camera: %s\n", cameraModeNames[camMode]); break;
+        case '[': camTarget = nextCameraTarget(camTarget, -1); break;  // corpo seguido anterior
+        case ']': camTarget = nextCameraTarget(camTarget, 1); break;   // próximo (planetas, depois luas)
+        case 'p': paused = !paused;        break;  // pausa/continua animação
+        case 'o': showOrbits = !showOrbits;break;  // mostra/esconde órbitas
+        case 't': reloadTexturesAsync();   break;  // recarrega texturas sem travar
+        case 'T': flushTrace();            break;  // salva o trace (Chrome/Perfetto)
+        case 'r': softwareBackend = !softwareBackend; break;  // OpenGL <-> rasterizador em software
+        case 'R': saveRayTracedStill();    break;  // imagem de referência (ray tracing)
+        case 'V': toggleVideo();           break;  // inicia/encerra gravação de vídeo
+        case 'P': savePoster();            break;  // captura em 4x a resolução da janela
+        case 'v': viewLayout = (viewLayout + 1) % VIEW_LAYOUTS; break;  // alterna o layout de vistas
+        case 'A': showAtmospheres = !showAtmospheres; break;   // liga/desliga as atmosferas
+        case 'S': showShadows = !showShadows; break;           // liga/desliga as sombras
+        case 'H': showHdr = !showHdr; break;                   // HDR + bloom <-> framebuffer de 8 bits
+        case 'e': exposure /= 1.25f; break;                    // exposição do tonemapping
+        case 'E': exposure *= 1.25f; break;
+        case 'b': showBelts = !showBelts; break;               // cinturões de asteroides e de Kuiper
+        case 'C': showComets = !showComets; break;             // cometas e caudas
+    }
+}
+
+// Um tick da simulação: eventos do replay + passo fixo. Chamado por update()
+// a cada 16 ms, ou por quadro de vídeo durante a gravação.
+void simulationTick() {
+    while (replaying && replayNext < replayEvents.size() && replayEvents[replayNext].tick == simTick) {
+        unsigned char key = replayEvents[replayNext++].key;
+        if (key == 0) finishReplay();
+        if (!isOutputKey(key)) applyKey(key);   // logs da versão 1 ainda as trazem
+    }
+    if (!paused) stepSimulation();
+    stepCameraRig(camRig);              // a câmera suaviza mesmo pausada
+    simTick++;
+}
+
+void update(int value) {
+    TRACE_SCOPE("update");
+    pollTextureUploads();                   // uploads de texturas em segundo plano
+    if (firstFrameDone) updateDeferredTextures();
+    if (!video.active) simulationTick();    // gravando: o tempo avança por quadro de vídeo
+    glutPostRedisplay();
+    glutTimerFunc(16, update, 0);
+}
+
+void keyboard(unsigned char key, int x, int y) {
+    if (replaying) return;                 // durante o replay só valem as teclas gravadas
+    if (key == 0) return;                  // 0 marca o fim da sessão no log
+    if (!isOutputKey(key)) recordEvent(key);
+    applyKey(key);
+    glutPostRedisplay();
+}
+
+// --headless[=N]: sem janela nem GPU; N quadros no rasterizador em software,
+// imprime o tempo médio e salva o último quadro em software.ppm
+int runHeadless(int frames) {
+    initStars();
+    double total = 0.0;
+    for (int f = 0; f < frames; ++f) {
+        stepSimulation();
+        stepCameraRig(camRig);
+        double t0 = nowMs();
+        renderSoftware(winWidth, winHeight);
+        if (f > 0) total += nowMs() - t0;       // o primeiro quadro inclui a carga das texturas
+    }
+    if (frames > 1)
+        printf("Software (%dx%d, %d threads): %.2f ms/quadro em %d quadros\n",
+               winWidth, winHeight, poolThreads(), total / (frames - 1), frames - 1);
+    if (writePPM("software.ppm", sw.color.data(), sw.width, sw.height))
+        printf("Ultimo quadro salvo em software.ppm\n");
+    return 0;
+}
+
+// --check-allocs[=N]: N quadros sem janela (padrão 1000), em duas passadas.
+// Na de CPU, o trabalho de update() e display() no rasterizador em software:
+// passo da simulação e da câmera, reset da arena, montagem da cena com
+// descarte e o quadro. Na de GL, os mesmos quadros de display() (Sol,
+// planetas, cinturões, sombras, HDR) num contexto EGL sem janela; ali só
+// contam as alocações feitas pelo código do programa, não as do driver.
+// Passado o aquecimento, nenhum quadro pode alocar; sai com 1 e mostra os
+// locais de chamada se algum alocar. Precisa do gancho de alocações (binário
+// solar-check, build Debug ou -DSOLAR_ALLOC_HOOK=ON); sem ele sai com 1.
+// Sem EGL (ou sem driver), a passada de GL é pulada com um aviso.
+const int ALLOC_CHECK_WARMUP = 60;
+
+// Contexto GL sem janela nem display: EGL surfaceless do Mesa (ou o display
+// padrão) com um pbuffer do tamanho da janela
+bool createHeadlessContext(int width, int height) {
+#ifdef SOLAR_HAVE_EGL
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (dpy == EGL_NO_DISPLAY) dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint major, minor;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) return false;
+    const EGLint attribs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                              EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_DEPTH_SIZE, 24, EGL_NONE};
+    const EGLint size[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(dpy, attribs, &config, 1, &configs) || configs == 0) return false;
+    EGLSurface surface = eglCreatePbufferSurface(dpy, config, size);
+    EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, NULL);
+    return surface != EGL_NO_SURFACE && ctx != EGL_NO_CONTEXT && eglMakeCurrent(dpy, surface, surface, ctx);
+#else
+    (void)width;
+    (void)height;
+    return false;
+#endif
+}
+
+void allocCheckFrameCpu() {
+    simulationTick();
+    arenaReset();
+    buildFrameScene(viewLayout, winWidth, winHeight);
+    renderSoftware(winWidth, winHeight);
+}
+
+void allocCheckFrameGL() {
+    pollTextureUploads();
+    simulationTick();
+    drawFrame();
+    glFinish();                             // o lugar da troca de buffers
+}
+
+// Uma passada: N quadros de frame(); devolve as alocações depois do aquecimento
+unsigned long allocCheckPass(const char* name, int frames, void (*frame)()) {
+    unsigned long steadyAllocs = 0;
+    int framesWithAllocs = 0, firstBad = -1;
+    for (int f = 0; f < frames; ++f) {
+        if (f == ALLOC_CHECK_WARMUP) allocTracker.enabled = true;
+        unsigned long before = allocTracker.count.load();
+        frame();
+        unsigned long n = allocTracker.count.load() - before;
+        if (f >= ALLOC_CHECK_WARMUP && n) {
+            steadyAllocs += n;
+            framesWithAllocs++;
+            if (firstBad < 0) firstBad = f;
+        }
+    }
+    allocTracker.enabled = false;
+    printf("  %s: %lu alocacoes em %d quadros", name, steadyAllocs, framesWithAllocs);
+    if (firstBad >= 0) printf(" (primeiro: quadro %d)", firstBad);
+    printf("\n");
+    return steadyAllocs;
+}
+
+int runAllocCheck(int frames) {
+    if (!allocHookCompiled) {
+        printf("Alocacoes: indisponivel, este binario foi compilado sem o gancho de alocacoes\n");
+        printf("  (use o solar-check, um build Debug ou -DSOLAR_ALLOC_HOOK=ON)\n");
+        return 1;
+    }
+    initStars();
+    void* probe[4];
+    backtrace(probe, 4);                                     // carrega o unwinder antes de ligar o gancho
+    frames = std::max(frames, ALLOC_CHECK_WARMUP + 1);
+    printf("Alocacoes: %d quadros por passada (%d de aquecimento), %dx%d; regime estavel:\n",
+           frames, ALLOC_CHECK_WARMUP, winWidth, winHeight);
+    unsigned long steadyAllocs = allocCheckPass("CPU (software)", frames, allocCheckFrameCpu);
+    printf("  arena do quadro: pico %.1f KB, %lu idas ao heap\n", frameArena.peak / 1024.0, frameArena.heapAllocs);
+
+    if (createHeadlessContext(winWidth, winHeight)) {
+        initGraphics();
+        reshape(winWidth, winHeight);
+        softwareBackend = false;
+        allocTracker.ownCodeOnly = true;
+        steadyAllocs += allocCheckPass("GL (display)", frames, allocCheckFrameGL);
+        allocTracker.ownCodeOnly = false;
+    } else {
+        printf("  GL: sem contexto EGL sem janela, passada pulada\n");
+    }
+    if (steadyAllocs) printAllocSites(10);
+    printf("Alocacoes: %s\n", steadyAllocs ? "FALHOU" : "OK");
+    return steadyAllocs ? 1 : 0;
+}
+
+// --raytrace[=spp]: uma imagem de referência sem janela, salva em raytrace.ppm
+int runRayTrace(int spp) {
+    initStars();
+    stepSimulation();
+    stepCameraRig(camRig);
+    renderRayTraced(winWidth, winHeight, spp);
+    if (writePPM("raytrace.ppm", rtPixels.data(), winWidth, winHeight))
+        printf("Imagem salva em raytrace.ppm\n");
+    return 0;
+}
+
+// --check-stability[=N]: roda N passos só da simulação (padrão 10^8, ~5e6
+// unidades de tempo) e confere órbitas e rotações contra uma referência em
+// long double, e a precisão das posições em float com a origem flutuante.
+// Sai com 1 se algum erro passar do limite.
+int runStabilityCheck(unsigned long long steps) {
+    printf("Estabilidade: %llu passos (t final = %.0f)\n", steps, steps * SIM_DT);
+    cometCount = 0;                                          // só órbitas e rotações
+    double t0 = nowMs();
+    for (unsigned long long i = 0; i < steps; ++i) stepSimulation();
+    printf("  simulacao: %.1f s\n", (nowMs() - t0) / 1000.0);
+
+    // Esquema antigo (float t += 0.05f), só para comparação
+    volatile float oldT = 0.0f;
+    for (unsigned long long i = 0; i < steps; ++i) oldT = oldT + 0.05f;
+
+    bool ok = true;
+    const long double twoPi = 6.283185307179586476925286766559L;
+    long double refT = (long double)steps * (long double)SIM_DT;
+    double maxOrbitErr = 0.0, maxSpinErr = 0.0, oldOrbitErr = 0.0;
+    BodyInstance bodies[NUM_BODIES];
+    computeBodies(bodies);
+    for (int i = 0; i < 8; ++i) {
+        long double a = fmodl(refT * (long double)orbitSpeeds[i], twoPi);
+        long double rx = orbitRadii[i] * cosl(a), rz = orbitRadii[i] * sinl(a);
+        double err = (double)sqrtl((bodies[i + 1].world[0] - rx) * (bodies[i + 1].world[0] - rx)
+                                 + (bodies[i + 1].world[2] - rz) * (bodies[i + 1].world[2] - rz)) / orbitRadii[i];
+        maxOrbitErr = std::max(maxOrbitErr, err);
+
+        long double oldA = fmodl((long double)oldT * orbitSpeeds[i], twoPi);
+        oldOrbitErr = std::max(oldOrbitErr, (double)fabsl(remainderl(oldA - a, twoPi)));
+
+        // Rotação que o sistema de spin do ECS entrega ao desenho
+        SolarSystem& s = solarEntities();
+        Entity e = s.slotEntity[i + 1];
+        const Spin* sp = ecsGet<Spin>(s.ecs, e);
+        float drawn = spinAngle(*sp, ecsGet<Orbit>(s.ecs, e), (double)simSteps, t);
+        long double spin = fmodl((long double)steps * (long double)sp->degPerStep, 360.0L);
+        maxSpinErr = std::max(maxSpinErr, (double)fabsl(remainderl(drawn - spin, 360.0L)));
+    }
+    printf("  orbitas: erro max %.2e rad (limite 1e-8); float antigo: t = %.0f, erro %.2f rad\n",
+           maxOrbitErr, (double)oldT, oldOrbitErr);
+    printf("  rotacao propria: erro max %.2e graus (limite 1e-3)\n", maxSpinErr);
+    ok = ok && maxOrbitErr < 1e-8 && maxSpinErr < 1e-3;
+
+    // Origem flutuante: câmera a 10 unidades de cada corpo; a posição em float
+    // (relativa à origem) deve reconstruir a posição em double
+    double maxFloatErr = 0.0, noOriginErr = 0.0;
+    for (int i = 0; i < NUM_BODIES; ++i) {
+        double eye[3] = {bodies[i].world[0] + 10.0, bodies[i].world[1], bodies[i].world[2]};
+        updateFloatingOrigin(eye);
+        BodyInstance rel[NUM_BODIES];
+        computeBodies(rel);
+        for (int k = 0; k < 3; ++k) {
+            maxFloatErr = std::max(maxFloatErr, fabs((double)rel[i].pos[k] + worldOrigin[k] - rel[i].world[k]));
+            noOriginErr = std::max(noOriginErr, fabs((double)(float)rel[i].world[k] - rel[i].world[k]));
+        }
+    }
+    printf("  posicoes em float: erro max %.2e unidades com origem flutuante (limite 1e-3), %.2e sem\n",
+           maxFloatErr, noOriginErr);
+    ok = ok && maxFloatErr < 1e-3;
+    printf("Estabilidade: %s\n", ok ? "OK" : "FALHOU");
+    return ok ? 0 : 1;
+}
+
+// --bench-graph[=N]: grafo aleatório com N nós (padrão 100000). Mede a
+// passada com tudo mudando, com 1% das locais mudando e parado, e confere as
+// transformações contra uma referência escalar em double. Sai com 1 se errar.
+int runGraphBench(int nodes) {
+    SceneGraph g;
+    uint64_t state = (uint64_t)starSeed * 0x9E3779B97F4A7C15ULL + 7;
+    for (int i = 0; i < nodes; ++i)
+        sgAddNode(g, i < 4 ? -1 : (int)(splitMix64(state) % (uint64_t)i));
+    std::vector<int> remap;
+    sgFinalize(g, remap);
+
+    auto randomLocal = [&](int i) {
+        float axis[3] = {uniform01(state) - 0.5f, uniform01(state) - 0.5f, uniform01(state) - 0.5f};
+        float len = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]) + 1e-6f;
+        Mat4 m = mat4Rotate(360.0f * uniform01(state), axis[0] / len, axis[1] / len, axis[2] / len);
+        float rot[9];
+        for (int c = 0; c < 3; ++c)
+            for (int r = 0; r < 3; ++r) rot[c * 3 + r] = m.m[c * 4 + r];
+        double pos[3] = {20.0 * uniform01(state) - 10.0, 20.0 * uniform01(state) - 10.0, 20.0 * uniform01(state) - 10.0};
+        sgSetLocal(g, i, rot, pos);
+    };
+    for (int i = 0; i < nodes; ++i) randomLocal(i);
+    sgUpdate(g);
+
+    const int passes = 20;
+    double full = 0.0, partial = 0.0, idle = 0.0;
+    long long partialNodes = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (int i = 0; i < nodes; ++i) randomLocal(i);
+        double t0 = nowMs();
+        sgUpdate(g);
+        full += nowMs() - t0;
+
+        for (int k = 0; k < nodes / 100; ++k) randomLocal((int)(splitMix64(state) % (uint64_t)nodes));
+        t0 = nowMs();
+        sgUpdate(g);
+        partial += nowMs() - t0;
+        partialNodes += g.updated;
+
+        t0 = nowMs();
+        sgUpdate(g);
+        idle += nowMs() - t0;
+    }
+
+    // Referência: mesma pré-ordem, contas escalares em double
+    std::vector<double> refRot((size_t)nodes * 9), refPos((size_t)nodes * 3);
+    std::vector<int> depth(nodes, 0);
+    double posErr = 0.0, rotErr = 0.0;
+    int maxDepth = 0;
+    for (int i = 0; i < nodes; ++i) {
+        int p = g.parent[i];
+        const float* L = g.localRot[i].col;
+        const double* lp = g.localPos[i].p;
+        double* R = &refRot[(size_t)i * 9];
+        double* T = &refPos[(size_t)i * 3];
+        if (p < 0) {
+            for (int c = 0; c < 3; ++c)
+                for (int r = 0; r < 3; ++r) R[c * 3 + r] = L[c * 4 + r];
+            for (int k = 0; k < 3; ++k) T[k] = lp[k];
+        } else {
+            depth[i] = depth[p] + 1;
+            const double* PR = &refRot[(size_t)p * 9];
+            const double* PT = &refPos[(size_t)p * 3];
+            for (int c = 0; c < 3; ++c)
+                for (int r = 0; r < 3; ++r)
+                    R[c * 3 + r] = PR[r] * L[c * 4] + PR[3 + r] * L[c * 4 + 1] + PR[6 + r] * L[c * 4 + 2];
+            for (int r = 0; r < 3; ++r) T[r] = PT[r] + PR[r] * lp[0] + PR[3 + r] * lp[1] + PR[6 + r] * lp[2];
+        }
+        maxDepth = std::max(maxDepth, depth[i]);
+        double pos[3];
+        float rot[9];
+        sgWorld(g, i, pos, rot);
+        for (int k = 0; k < 3; ++k) posErr = std::max(posErr, fabs(pos[k] - T[k]));
+        for (int k = 0; k < 9; ++k) rotErr = std::max(rotErr, fabs((double)rot[k] - R[k]));
+    }
+
+    printf("Grafo de cena: %d nos (profundidade max %d)\n", nodes, maxDepth);
+    printf("  tudo mudando: %.2f ms/passada\n", full / passes);
+    printf("  1%% mudando:   %.2f ms/passada (%lld nos recalculados)\n", partial / passes, partialNodes / passes);
+    printf("  parado:       %.3f ms/passada\n", idle / passes);
+    printf("  erro max contra double: posicao %.2e, rotacao %.2e\n", posErr, rotErr);
+    bool ok = posErr < 1e-3 && rotErr < 1e-4;
+    printf("Grafo de cena: %s\n", ok ? "OK" : "FALHOU");
+    return ok ? 0 : 1;
+}
+
+// --bench-decode[=N]: decodifica N vezes (padrão 5) cada imagem de textures/
+// com cada backend, em tamanho cheio e reduzida a 1/2, 1/4 e 1/8, e mostra
+// MB/s (bytes do arquivo) e Mpix/s. Confere os backends entre si em tamanho
+// cheio (mesma orientação, diferença de IDCT pequena); sai com 1 se divergirem.
+int runDecodeBench(int passes) {
+    struct File {
+        char name[256];
+        std::vector<unsigned char> bytes;
+    };
+    std::vector<File> files;
+    if (DIR* dir = opendir("textures")) {
+        while (dirent* e = readdir(dir)) {
+            if (e->d_name[0] == '.') continue;
+            char path[512];
+            snprintf(path, sizeof(path), "textures/%s", e->d_name);
+            FILE* f = fopen(path, "rb");
+            if (!f) continue;
+            File file;
+            snprintf(file.name, sizeof(file.name), "%s", e->d_name);
+            unsigned char buf[65536];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), f)) > 0) file.bytes.insert(file.bytes.end(), buf, buf + n);
+            fclose(f);
+            files.push_back(file);
+        }
+        closedir(dir);
+    }
+    if (files.empty()) {
+        printf("Erro ao abrir textures/ (rode da raiz do repositorio)\n");
+        return 1;
+    }
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return strcmp(a.name, b.name) < 0; });
+    // Cada arquivo fica com o primeiro backend que o aceita (como no programa);
+    // esse grupo é medido com ele e com o stb_image, que aceita tudo
+    const ImageDecoder* ref = imageDecoders[0];
+    for (const ImageDecoder** d = imageDecoders; *d; ++d) ref = *d;
+    std::vector<const ImageDecoder*> owner;
+    for (const File& f : files) {
+        const ImageDecoder** d = imageDecoders;
+        while (*d != ref && !(*d)->accepts(f.bytes.data(), f.bytes.size())) ++d;
+        owner.push_back(*d);
+    }
+    printf("Decodificacao: %zu arquivos em textures/, %d passadas\n", files.size(), passes);
+    printf("  %-16s %7s %9s %9s\n", "backend", "escala", "MB/s", "Mpix/s");
+
+    std::vector<unsigned char> rgba;
+    VectorSink sink = {&rgba, 0, 0};
+    for (const ImageDecoder** group = imageDecoders; *group; ++group) {
+        size_t groupFiles = 0, groupBytes = 0;
+        for (size_t i = 0; i < files.size(); ++i)
+            if (owner[i] == *group) { groupFiles++; groupBytes += files[i].bytes.size(); }
+        if (groupFiles == 0) continue;
+        printf("  arquivos do %s: %zu (%.2f MB)\n", (*group)->name, groupFiles, groupBytes / 1e6);
+        const ImageDecoder* backends[2] = {*group, ref};
+        for (int b = 0; b < (*group == ref ? 1 : 2); ++b) {
+            for (int scale = 1; scale <= 8; scale *= 2) {
+                size_t bytes = 0;
+                double pixels = 0.0, ms = 0.0;
+                for (int pass = 0; pass < passes; ++pass)
+                    for (size_t i = 0; i < files.size(); ++i) {
+                        if (owner[i] != *group) continue;
+                        const File& f = files[i];
+                        double t0 = nowMs();
+                        if (!backends[b]->decode(f.bytes.data(), f.bytes.size(), scale, vectorSink, &sink)) continue;
+                        ms += nowMs() - t0;
+                        bytes += f.bytes.size();
+                        pixels += (double)sink.w * sink.h;
+                    }
+                if (ms <= 0.0) continue;
+                printf("  %-16s %5s%d %9.1f %9.1f\n", backends[b]->name, "1/", scale,
+                       bytes / ms / 1e3, pixels / ms / 1e3);
+            }
+        }
+    }
+
+    // Cada backend contra o stb_image nos seus arquivos, em tamanho cheio
+    bool ok = true;
+    std::vector<unsigned char> refRgba;
+    VectorSink refSink = {&refRgba, 0, 0};
+    for (const ImageDecoder** d = imageDecoders; *d != ref; ++d) {
+        double sum = 0.0;
+        size_t count = 0;
+        int maxDiff = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (owner[i] != *d) continue;
+            const File& f = files[i];
+            bool a = (*d)->decode(f.bytes.data(), f.bytes.size(), 1, vectorSink, &sink);
+            bool b = ref->decode(f.bytes.data(), f.bytes.size(), 1, vectorSink, &refSink);
+            if (!a || !b || sink.w != refSink.w || sink.h != refSink.h) {
+                printf("  %s: %s falhou ou mudou o tamanho\n", (*d)->name, f.name);
+                ok = false;
+                continue;
+            }
+            for (size_t k = 0; k < rgba.size(); ++k) {
+                int diff = abs((int)rgba[k] - (int)refRgba[k]);
+                sum += diff;
+                maxDiff = std::max(maxDiff, diff);
+            }
+            count += rgba.size();
+        }
+        double mean = count ? sum / count : 0.0;
+        printf("  %s contra %s: diferenca media %.3f, max %d (limite da media 1.0)\n",
+               (*d)->name, ref->name, mean, maxDiff);
+        ok = ok && mean < 1.0;
+    }
+    printf("Decodificacao: %s\n", ok ? "OK" : "FALHOU");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv){
+    startupStart = nowMs();
+    starSeed = (unsigned)time(NULL);                         // varia por execução (salvo no replay)
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    int headlessFrames = 0, raytraceSpp = 0;
+    unsigned long long stabilitySteps = 0;
+    int graphNodes = 0, allocFrames = 0, decodePasses = 0;
+    for (int i = 1; i < argc; ++i) {                         // opções do programa (o GLUT ignora)
+        if (strcmp(argv[i], "--no-pack") == 0) usePack = false;
+        else if (strcmp(argv[i], "--fast-start") == 0) fastStart = true;
+        else if (strcmp(argv[i], "--cold-start") == 0) coldStart = true;
+        else if (strncmp(argv[i], "--texture-scale=", 16) == 0) textureScale = atoi(argv[i] + 16);
+        else if (strncmp(argv[i], "--decoder=", 10) == 0) {
+            forcedDecoder = findImageDecoder(argv[i] + 10);
+            if (!forcedDecoder) {
+                printf("Decodificador desconhecido: %s (disponiveis:", argv[i] + 10);
+                for (const ImageDecoder** d = imageDecoders; *d; ++d) printf(" %s", (*d)->name);
+                printf(")\n");
+                return 1;
+            }
+        }
+        else if (strncmp(argv[i], "--startup-trace=", 16) == 0) startupTracePath = argv[i] + 16;
+        else if (strncmp(argv[i], "--seed=", 7) == 0) starSeed = (unsigned)strtoul(argv[i] + 7, NULL, 10);
+        else if (strncmp(argv[i], "--record=", 9) == 0) recordPath = argv[i] + 9;
+        else if (strncmp(argv[i], "--replay=", 9) == 0) replayPath = argv[i] + 9;
+        else if (strcmp(argv[i], "--software") == 0) softwareBackend = true;
+        else if (strncmp(argv[i], "--bench=", 8) == 0) benchFrames = atoi(argv[i] + 8);
+        else if (strcmp(argv[i], "--headless") == 0) headlessFrames = 100;
+        else if (strncmp(argv[i], "--headless=", 11) == 0) headlessFrames = atoi(argv[i] + 11);
+        else if (strcmp(argv[i], "--raytrace") == 0) raytraceSpp = 16;
+        else if (strncmp(argv[i], "--raytrace=", 11) == 0) raytraceSpp = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--video=", 8) == 0) video.path = argv[i] + 8;
+        else if (strncmp(argv[i], "--video-fps=", 12) == 0) video.fps = std::max(1, atoi(argv[i] + 12));
+        else if (strncmp(argv[i], "--video-frames=", 15) == 0) video.maxFrames = atol(argv[i] + 15);
+        else if (strncmp(argv[i], "--poster=", 9) == 0) sscanf(argv[i] + 9, "%dx%d", &posterWidth, &posterHeight);
+        else if (strncmp(argv[i], "--poster-out=", 13) == 0) posterPath = argv[i] + 13;
+        else if (strncmp(argv[i], "--camera=", 9) == 0) {            // --camera=modo[:corpo]
+            for (int m = 0; m < CAM_MODES; ++m)
+                if (strncmp(argv[i] + 9, cameraModeNames[m], strlen(cameraModeNames[m])) == 0) camMode = m;
+            const char* colon = strchr(argv[i], ':');
+            if (colon) {
+                camTarget = atoi(colon + 1);
+                if (camTarget < 0 || camTarget >= NUM_BODIES) {
+                    printf("Corpo invalido para a camera: %s (0 a %d)\n", colon + 1, NUM_BODIES - 1);
+                    return 1;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--true-scale") == 0) trueScale = true;
+        else if (strncmp(argv[i], "--depth=", 8) == 0) {
+            for (int m = 0; m < DEPTH_MODES; ++m)
+                if (strcmp(argv[i] + 8, depthModeNames[m]) == 0) depthMode = m;
+        }
+        else if (strcmp(argv[i], "--no-atmosphere") == 0) useAtmosphere = false;
+        else if (strcmp(argv[i], "--no-shadows") == 0) useShadows = false;
+        else if (strcmp(argv[i], "--no-hdr") == 0) useHdr = false;
+        else if (strncmp(argv[i], "--exposure=", 11) == 0) exposure = (float)atof(argv[i] + 11);
+        else if (strncmp(argv[i], "--belt=", 7) == 0) beltParticles = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--comets=", 9) == 0) cometCount = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--views=", 8) == 0) {
+            viewLayout = atoi(argv[i] + 8);
+            if (viewLayout < 0 || viewLayout >= VIEW_LAYOUTS) {
+                printf("Layout de vistas invalido: %s (0 a %d)\n", argv[i] + 8, VIEW_LAYOUTS - 1);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--check-stability") == 0) stabilitySteps = 100000000ULL;
+        else if (strncmp(argv[i], "--check-stability=", 18) == 0) stabilitySteps = strtoull(argv[i] + 18, NULL, 10);
+        else if (strcmp(argv[i], "--bench-graph") == 0) graphNodes = 100000;
+        else if (strncmp(argv[i], "--bench-graph=", 14) == 0) graphNodes = atoi(argv[i] + 14);
+        else if (strcmp(argv[i], "--check-allocs") == 0) allocFrames = 1000;
+        else if (strncmp(argv[i], "--check-allocs=", 15) == 0) allocFrames = atoi(argv[i] + 15);
+        else if (strcmp(argv[i], "--bench-decode") == 0) decodePasses = 5;
+        else if (strncmp(argv[i], "--bench-decode=", 15) == 0) decodePasses = atoi(argv[i] + 15);
+        else if (strncmp(argv[i], "--size=", 7) == 0) sscanf(argv[i] + 7, "%dx%d", &winWidth, &winHeight);
+    }
+    if (replayPath && !loadReplay(replayPath)) return 1;    // depois das opções: o cabeçalho prevalece
+    if (trueScale) applyTrueScale();
+    if (stabilitySteps > 0) return runStabilityCheck(stabilitySteps);
+    if (graphNodes > 0) return runGraphBench(graphNodes);
+    if (allocFrames > 0) return runAllocCheck(allocFrames);
+    if (decodePasses > 0) return runDecodeBench(decodePasses);
+    if (textureScale != 1 && textureScale != 2 && textureScale != 4 && textureScale != 8) {
+        printf("Aviso: --texture-scale deve ser 1, 2, 4 ou 8; usando 1\n");
+        textureScale = 1;
+    }
+    if (headlessFrames > 0) return runHeadless(headlessFrames);
+    if (raytraceSpp > 0) return runRayTrace(raytraceSpp);
+    if (benchFrames) softwareBackend = false;                // o benchmark começa pelo OpenGL
+
+    startupPhase("glutInit");
+    glutInit(&argc, argv);                                   
+    if (recordPath && !replaying && !startRecording(recordPath)) return 1;
+    startupPhase("janela");
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);// double buffer + cor + depth
+    glutInitWindowSize(winWidth, winHeight);                 // tamanho da janela
+    glutCreateWindow("Sistema Solar");                       // cria janela
+
+    initGraphics();
+    if (posterWidth > 0 && posterHeight > 0)                 // só a captura, sem abrir o loop
+        return renderPoster(posterWidth, posterHeight, posterPath) ? 0 : 1;
+    startupPhase("primeiro quadro");
+
+    glutDisplayFunc(display);
+    glutReshapeFunc(reshape);
+    glutKeyboardFunc(keyboard);
+    glutTimerFunc(0, update, 0);
+    glutIdleFunc(videoIdle);
+
+    glutMainLoop();
+    return 0;
+}
@@ -0,0 +1,22 @@
+// Programa: estado da simulação, teclado, laço do GLUT, modos de linha de
+// comando (--headless, --check-*, --bench-*) e gravação/replay de sessões
+#ifndef SOLAR_APP_H
+#define SOLAR_APP_H
+
+#include "common.h"
+
+// Tempo da simulação: um contador inteiro de passos é a única coisa que se
+// acumula (exato para sempre). t, os ângulos e as rotações derivam dele em
+// double e são reduzidos ao período antes de virar float.
+const double SIM_DT = 0.05;    // tempo por passo
+
+extern unsigned long long simSteps; // passos de stepSimulation (não avança pausado)
+extern double t;                    // tempo "global" = simSteps * SIM_DT (animações e cintilação das estrelas)
+extern bool paused;                 // controle de pausa
+extern bool showOrbits;             // liga/desliga desenho das órbitas
+extern int winWidth, winHeight;     // tamanho atual da janela
+
+void reshape(int w, int h);
+void simulationTick();
+
+#endif
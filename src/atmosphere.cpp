@@ -0,0 +1,414 @@
+#include "atmosphere.h"
+
+#include "texpack.h"
+#include "hdr.h"
+#include "render.h"
+#include "runtime.h"
+
+// ---------------------------------------------------------------------------
+// Espalhamento atmosférico (Vênus e Terra). Tabelas pré-calculadas à moda de
+// Bruneton: transmitância T(r, mu) em 2D e espalhamento simples Rayleigh/Mie
+// S(r, mu, mu_s, nu) em 4D (guardado numa textura 3D com nu e mu_s lado a
+// lado em x). São calculadas uma vez no pool de threads e gravadas em disco
+// (atmosphere_<planeta>_<checksum>.lut); em cada quadro a atmosfera é uma
+// casca esférica cujo shader só faz algumas leituras das tabelas.
+struct AtmosphereParams {      // km e 1/km
+    float groundRadius, topRadius;
+    float rayleigh[3], rayleighHeight;      // coeficiente de espalhamento no solo e altura de escala
+    float mie, mieHeight, mieG;             // Mie (cinza): espalhamento, altura de escala, anisotropia
+    float absorption[3];                    // só extinção (ozônio / nuvens de enxofre), perfil do Rayleigh
+    float sunIntensity;
+};
+
+struct AtmosphereProfile {
+    const char* name;
+    AtmosphereParams params;
+};
+
+const int ATMOSPHERE_PROFILES = 2;
+const AtmosphereProfile atmosphereProfiles[ATMOSPHERE_PROFILES] = {
+    {"venus", {6052.0f, 6152.0f, {4.0e-3f, 5.0e-3f, 6.5e-3f}, 15.9f, 12.0e-3f, 6.0f, 0.7f,
+               {0.4e-3f, 1.6e-3f, 5.0e-3f}, 16.0f}},
+    {"earth", {6360.0f, 6420.0f, {5.802e-3f, 13.558e-3f, 33.1e-3f}, 8.0f, 3.996e-3f, 1.2f, 0.8f,
+               {0.65e-3f, 1.881e-3f, 0.085e-3f}, 20.0f}},
+};
+const int planetAtmosphere[8] = {-1, 0, 1, -1, -1, -1, -1, -1};   // perfil de cada planeta (-1 = sem)
+const float ATMOSPHERE_EXAGGERATION = 6.0f;   // espessura na escala comprimida (senão some na tela)
+
+// Resolução das tabelas (a mesma está no shader)
+const int ATMO_T_W = 256, ATMO_T_H = 64;                          // transmitância: mu x r
+const int ATMO_S_R = 16, ATMO_S_MU = 128, ATMO_S_MUS = 32, ATMO_S_NU = 8;
+const int ATMO_STEPS = 40;                                        // passos de integração por texel
+
+const uint32_t ATMO_MAGIC   = 0x54415353;   // "SSAT"
+const uint32_t ATMO_VERSION = 1;
+
+struct AtmosphereCacheHeader {
+    uint32_t magic, version;
+    uint32_t dims[6];               // ATMO_T_W, ATMO_T_H, ATMO_S_R, ATMO_S_MU, ATMO_S_MUS, ATMO_S_NU
+    uint64_t paramsChecksum;        // parâmetros usados no cálculo
+    uint64_t dataChecksum;          // transmitância + espalhamento
+};
+
+struct AtmosphereLut {
+    AtmosphereParams params;                // já com o exagero de espessura aplicado
+    std::vector<float> transmittance;       // [r][mu] RGB
+    std::vector<float> scattering;          // [r][mu][nu][mu_s] RGBA (Rayleigh RGB, Mie R)
+    GLuint transmittanceTex, scatteringTex;
+};
+AtmosphereLut atmosphereLuts[ATMOSPHERE_PROFILES];
+
+GLuint atmosphereProgram = 0, atmosphereSphere = 0;
+GLint atmoCenterLoc, atmoShellLoc, atmoSunLoc, atmoKmLoc, atmoGroundLoc, atmoTopLoc;
+GLint atmoRayleighLoc, atmoMieGLoc, atmoIntensityLoc, atmoFcoefLoc, atmoHdrLoc;
+bool useAtmosphere = true;
+bool showAtmospheres = true;
+
+// Parametrização das tabelas (idêntica no shader). rho = distância ao
+// horizonte; mu é dividido entre raios que atingem o solo (metade de baixo) e
+// os que escapam, com mais amostras perto do horizonte.
+void atmoDecodeR(const AtmosphereParams& p, float x, float* r, float* rho) {
+    float H = sqrtf(p.topRadius * p.topRadius - p.groundRadius * p.groundRadius);
+    *rho = x * H;
+    *r = sqrtf(*rho * *rho + p.groundRadius * p.groundRadius);
+}
+
+float atmoDecodeMu(float x, float r, float rho) {
+    float muH = -rho / r;
+    if (x < 0.5f) { float a = (0.5f - x) * 2.0f; return muH - a * a * (muH + 1.0f); }
+    float a = (x - 0.5f) * 2.0f;
+    return muH + a * a * (1.0f - muH);
+}
+
+float atmoDistanceToTop(const AtmosphereParams& p, float r, float mu) {
+    return -r * mu + sqrtf(std::max(0.0f, r * r * (mu * mu - 1.0f) + p.topRadius * p.topRadius));
+}
+
+float atmoDistanceToGround(const AtmosphereParams& p, float r, float mu) {
+    return -r * mu - sqrtf(std::max(0.0f, r * r * (mu * mu - 1.0f) + p.groundRadius * p.groundRadius));
+}
+
+// Coeficiente de extinção na altitude h
+void atmoExtinction(const AtmosphereParams& p, float h, float out[3]) {
+    float dr = expf(-h / p.rayleighHeight), dm = expf(-h / p.mieHeight);
+    for (int c = 0; c < 3; ++c)
+        out[c] = (p.rayleigh[c] + p.absorption[c]) * dr + p.mie * 1.11f * dm;   // Mie absorve ~10%
+}
+
+void atmoBuildTransmittanceRow(void* ctx, int row) {
+    AtmosphereLut& lut = *(AtmosphereLut*)ctx;
+    const AtmosphereParams& p = lut.params;
+    float r, rho;
+    atmoDecodeR(p, (float)row / (ATMO_T_H - 1), &r, &rho);
+    for (int i = 0; i < ATMO_T_W; ++i) {
+        float mu = -1.0f + 2.0f * i / (ATMO_T_W - 1);
+        float dt = atmoDistanceToTop(p, r, mu) / ATMO_STEPS, tau[3] = {0, 0, 0};
+        for (int s = 0; s < ATMO_STEPS; ++s) {
+            float d = (s + 0.5f) * dt;
+            float ri = sqrtf(d * d + 2.0f * r * mu * d + r * r), ext[3];
+            atmoExtinction(p, ri - p.groundRadius, ext);
+            for (int c = 0; c < 3; ++c) tau[c] += ext[c] * dt;
+        }
+        float* out = &lut.transmittance[((size_t)row * ATMO_T_W + i) * 3];
+        for (int c = 0; c < 3; ++c) out[c] = expf(-tau[c]);
+    }
+}
+
+// Transmitância do ponto (r, mu) até o topo (bilinear na tabela)
+void atmoSampleTransmittance(const AtmosphereLut& lut, float r, float mu, float out[3]) {
+    const AtmosphereParams& p = lut.params;
+    float H = sqrtf(p.topRadius * p.topRadius - p.groundRadius * p.groundRadius);
+    float rho = sqrtf(std::max(0.0f, r * r - p.groundRadius * p.groundRadius));
+    float fx = std::min(std::max((mu + 1.0f) * 0.5f, 0.0f), 1.0f) * (ATMO_T_W - 1);
+    float fy = std::min(rho / H, 1.0f) * (ATMO_T_H - 1);
+    int x0 = std::min((int)fx, ATMO_T_W - 2), y0 = std::min((int)fy, ATMO_T_H - 2);
+    float ax = fx - x0, ay = fy - y0;
+    const float* t00 = &lut.transmittance[((size_t)y0 * ATMO_T_W + x0) * 3];
+    const float* t10 = t00 + 3;
+    const float* t01 = t00 + ATMO_T_W * 3;
+    const float* t11 = t01 + 3;
+    for (int c = 0; c < 3; ++c)
+        out[c] = (t00[c] * (1 - ax) + t10[c] * ax) * (1 - ay) + (t01[c] * (1 - ax) + t11[c] * ax) * ay;
+}
+
+// Uma linha (r, mu) da tabela de espalhamento: todos os (nu, mu_s)
+void atmoBuildScatteringRow(void* ctx, int row) {
+    AtmosphereLut& lut = *(AtmosphereLut*)ctx;
+    const AtmosphereParams& p = lut.params;
+    float r, rho;
+    atmoDecodeR(p, (float)(row / ATMO_S_MU) / (ATMO_S_R - 1), &r, &rho);
+    float xmu = (float)(row % ATMO_S_MU) / (ATMO_S_MU - 1);
+    float mu = atmoDecodeMu(xmu, r, rho);
+    bool ground = xmu < 0.5f;
+    float dist = ground ? std::max(0.0f, atmoDistanceToGround(p, r, mu)) : atmoDistanceToTop(p, r, mu);
+    float dt = dist / ATMO_STEPS;
+    float* out = &lut.scattering[(size_t)row * ATMO_S_NU * ATMO_S_MUS * 4];
+
+    for (int inu = 0; inu < ATMO_S_NU; ++inu) {
+        for (int imus = 0; imus < ATMO_S_MUS; ++imus, out += 4) {
+            float mus = -0.2f + 1.2f * imus / (ATMO_S_MUS - 1);
+            float nu = -1.0f + 2.0f * inu / (ATMO_S_NU - 1);
+            float span = sqrtf(std::max(0.0f, (1.0f - mu * mu) * (1.0f - mus * mus)));
+            nu = std::min(std::max(nu, mu * mus - span), mu * mus + span);   // ângulos possíveis
+
+            float tau[3] = {0, 0, 0}, ray[3] = {0, 0, 0}, mie = 0.0f;
+            for (int s = 0; s < ATMO_STEPS; ++s) {
+                float d = (s + 0.5f) * dt;
+                float ri = sqrtf(d * d + 2.0f * r * mu * d + r * r), h = ri - p.groundRadius, ext[3];
+                atmoExtinction(p, h, ext);
+                for (int c = 0; c < 3; ++c) tau[c] += ext[c] * dt * 0.5f;   // até o meio do passo
+                float musi = (r * mus + d * nu) / ri;
+                if (musi > -sqrtf(std::max(0.0f, 1.0f - p.groundRadius * p.groundRadius / (ri * ri)))) {
+                    float sun[3];                                            // o Sol não está atrás do planeta
+                    atmoSampleTransmittance(lut, ri, musi, sun);
+                    float dr = expf(-h / p.rayleighHeight) * dt, dm = expf(-h / p.mieHeight) * dt;
+                    for (int c = 0; c < 3; ++c) ray[c] += expf(-tau[c]) * sun[c] * dr;
+                    mie += expf(-tau[0]) * sun[0] * dm;
+                }
+                for (int c = 0; c < 3; ++c) tau[c] += ext[c] * dt * 0.5f;
+            }
+            for (int c = 0; c < 3; ++c) out[c] = ray[c] * p.rayleigh[c];
+            out[3] = mie * p.mie;
+        }
+    }
+}
+
+void atmoCachePath(const char* name, uint64_t checksum, char* path, size_t size) {
+    snprintf(path, size, "atmosphere_%s_%08x.lut", name, (unsigned)(checksum & 0xFFFFFFFFu));
+}
+
+uint64_t atmoDataChecksum(const AtmosphereLut& lut) {
+    uint64_t h = packChecksum(lut.transmittance.data(), lut.transmittance.size() * sizeof(float));
+    return packChecksum(lut.scattering.data(), lut.scattering.size() * sizeof(float), h);
+}
+
+bool loadAtmosphereCache(AtmosphereLut& lut, const char* path, uint64_t paramsChecksum) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    AtmosphereCacheHeader hdr;
+    const uint32_t dims[6] = {ATMO_T_W, ATMO_T_H, ATMO_S_R, ATMO_S_MU, ATMO_S_MUS, ATMO_S_NU};
+    bool ok = fread(&hdr, sizeof(hdr), 1, f) == 1 && hdr.magic == ATMO_MAGIC && hdr.version == ATMO_VERSION
+           && memcmp(hdr.dims, dims, sizeof(dims)) == 0 && hdr.paramsChecksum == paramsChecksum
+           && fread(lut.transmittance.data(), sizeof(float), lut.transmittance.size(), f) == lut.transmittance.size()
+           && fread(lut.scattering.data(), sizeof(float), lut.scattering.size(), f) == lut.scattering.size()
+           && atmoDataChecksum(lut) == hdr.dataChecksum;
+    fclose(f);
+    if (!ok) printf("Cache de atmosfera invalido: %s (recalculando)\n", path);
+    return ok;
+}
+
+void saveAtmosphereCache(const AtmosphereLut& lut, const char* path, uint64_t paramsChecksum) {
+    AtmosphereCacheHeader hdr = {ATMO_MAGIC, ATMO_VERSION, {ATMO_T_W, ATMO_T_H, ATMO_S_R, ATMO_S_MU, ATMO_S_MUS, ATMO_S_NU},
+                                 paramsChecksum, atmoDataChecksum(lut)};
+    FILE* f = fopen(path, "wb");
+    if (!f) { printf("Erro ao criar %s\n", path); return; }
+    fwrite(&hdr, sizeof(hdr), 1, f);
+    fwrite(lut.transmittance.data(), sizeof(float), lut.transmittance.size(), f);
+    fwrite(lut.scattering.data(), sizeof(float), lut.scattering.size(), f);
+    fclose(f);
+}
+
+const char* atmosphereVertexShader =
+    "#version 120\n"
+    "uniform vec3 center;\n"                  // centro do planeta relativo à câmera
+    "uniform float shellRadius;\n"
+    "varying vec3 world;\n"
+    "varying float logz;\n"
+    "void main() {\n"
+    "    world = center + gl_Vertex.xyz * shellRadius;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(world, 1.0);\n"
+    "    logz = 1.0 + gl_Position.w;\n"
+    "}\n";
+
+const char* atmosphereFragmentShader =
+    "#version 120\n"
+    "uniform sampler2D transmittance;\n"
+    "uniform sampler3D scattering;\n"
+    "uniform vec3 center, sunPos, rayleigh;\n"
+    "uniform float kmPerUnit, groundRadius, topRadius, mieG, sunIntensity, fcoef;\n"
+    "uniform bool hdr;\n"                     // em HDR a exposição fica para o tonemapping
+    "varying vec3 world;\n"
+    "varying float logz;\n"
+    "const float T_W = 256.0, T_H = 64.0, S_R = 16.0, S_MU = 128.0, S_MUS = 32.0, S_NU = 8.0;\n"
+    "float texel(float x, float n) { return (0.5 + clamp(x, 0.0, 1.0) * (n - 1.0)) / n; }\n"
+    "vec3 transmittanceTo(float r, float mu) {\n"
+    "    float H = sqrt(topRadius * topRadius - groundRadius * groundRadius);\n"
+    "    float rho = sqrt(max(r * r - groundRadius * groundRadius, 0.0));\n"
+    "    return texture2D(transmittance, vec2(texel((mu + 1.0) * 0.5, T_W), texel(rho / H, T_H))).rgb;\n"
+    "}\n"
+    "vec4 scatteringAt(float r, float mu, float mus, float nu) {\n"
+    "    float H = sqrt(topRadius * topRadius - groundRadius * groundRadius);\n"
+    "    float rho = sqrt(max(r * r - groundRadius * groundRadius, 0.0));\n"
+    "    float muH = -rho / r;\n"
+    "    float xmu = mu < muH ? 0.5 - 0.5 * sqrt((muH - mu) / (muH + 1.0))\n"
+    "                         : 0.5 + 0.5 * sqrt((mu - muH) / (1.0 - muH));\n"
+    "    float fnu = clamp((nu + 1.0) * 0.5, 0.0, 1.0) * (S_NU - 1.0);\n"
+    "    float i = min(floor(fnu), S_NU - 2.0);\n"
+    "    float umus = texel((mus + 0.2) / 1.2, S_MUS);\n"
+    "    vec2 vw = vec2(texel(xmu, S_MU), texel(rho / H, S_R));\n"
+    "    vec4 a = texture3D(scattering, vec3((i + umus) / S_NU, vw));\n"
+    "    vec4 b = texture3D(scattering, vec3((i + 1.0 + umus) / S_NU, vw));\n"
+    "    return mix(a, b, fnu - i);\n"
+    "}\n"
+    "void main() {\n"
+    "    vec3 v = normalize(world);\n"         // a câmera está na origem
+    "    vec3 p = -center * kmPerUnit;\n"       // câmera relativa ao planeta, em km
+    "    float r = length(p), rmu = dot(p, v);\n"
+    "    if (r > topRadius) {\n"                // de fora: começa na entrada da atmosfera
+    "        float disc = rmu * rmu - r * r + topRadius * topRadius;\n"
+    "        if (disc < 0.0 || -rmu - sqrt(disc) < 0.0) discard;\n"
+    "        p += v * (-rmu - sqrt(disc));\n"
+    "        r = topRadius;\n"
+    "        rmu = dot(p, v);\n"
+    "    }\n"
+    "    vec3 s = normalize(sunPos - center);\n"
+    "    float mu = rmu / r, mus = dot(p, s) / r, nu = dot(v, s);\n"
+    "    vec4 S = scatteringAt(r, mu, mus, nu);\n"
+    "    vec3 mie = S.rgb * (S.a / max(S.r, 1e-9)) * (rayleigh.r / rayleigh);\n"
+    "    float g2 = mieG * mieG;\n"
+    "    float phaseR = 0.0596831 * (1.0 + nu * nu);\n"
+    "    float phaseM = 0.119366 * (1.0 - g2) * (1.0 + nu * nu) / ((2.0 + g2) * pow(1.0 + g2 - 2.0 * mieG * nu, 1.5));\n"
+    "    vec3 L = sunIntensity * (S.rgb * phaseR + mie * phaseM);\n"
+    "    float disc = r * r * (mu * mu - 1.0) + groundRadius * groundRadius;\n"
+    "    vec3 T;\n"
+    "    if (disc >= 0.0 && mu < 0.0) {\n"      // atinge o solo: razão de dois raios para cima
+    "        float d = -r * mu - sqrt(disc);\n"
+    "        T = transmittanceTo(groundRadius, -(r * mu + d) / groundRadius) / max(transmittanceTo(r, -mu), vec3(1e-6));\n"
+    "    } else {\n"
+    "        T = transmittanceTo(r, mu);\n"
+    "    }\n"
+    "    gl_FragColor = vec4(hdr ? L : 1.0 - exp(-L), clamp(dot(T, vec3(1.0 / 3.0)), 0.0, 1.0));\n"
+    "    gl_FragDepth = fcoef > 0.0 ? log2(logz) * fcoef : gl_FragCoord.z;\n"
+    "}\n";
+
+bool initAtmosphereProgram() {
+    atmosphereProgram = linkProgram(atmosphereVertexShader, atmosphereFragmentShader);
+    if (!atmosphereProgram) return false;
+    atmoCenterLoc = glGetUniformLocation(atmosphereProgram, "center");
+    atmoShellLoc = glGetUniformLocation(atmosphereProgram, "shellRadius");
+    atmoSunLoc = glGetUniformLocation(atmosphereProgram, "sunPos");
+    atmoKmLoc = glGetUniformLocation(atmosphereProgram, "kmPerUnit");
+    atmoGroundLoc = glGetUniformLocation(atmosphereProgram, "groundRadius");
+    atmoTopLoc = glGetUniformLocation(atmosphereProgram, "topRadius");
+    atmoRayleighLoc = glGetUniformLocation(atmosphereProgram, "rayleigh");
+    atmoMieGLoc = glGetUniformLocation(atmosphereProgram, "mieG");
+    atmoIntensityLoc = glGetUniformLocation(atmosphereProgram, "sunIntensity");
+    atmoFcoefLoc = glGetUniformLocation(atmosphereProgram, "fcoef");
+    atmoHdrLoc = glGetUniformLocation(atmosphereProgram, "hdr");
+    glUseProgram(atmosphereProgram);
+    glUniform1i(glGetUniformLocation(atmosphereProgram, "transmittance"), 1);
+    glUniform1i(glGetUniformLocation(atmosphereProgram, "scattering"), 2);
+    glUseProgram(0);
+    return true;
+}
+
+// Tabelas de cada perfil (do cache em disco ou calculadas no pool) + texturas
+bool initAtmosphere() {
+    if (!useAtmosphere) return false;
+    if (glVersion() < 30 || !initAtmosphereProgram()) {
+        printf("Sem GLSL 1.20 / texturas em float: atmosferas desligadas\n");
+        return false;
+    }
+    for (int i = 0; i < ATMOSPHERE_PROFILES; ++i) {
+        AtmosphereLut& lut = atmosphereLuts[i];
+        AtmosphereParams& p = lut.params;
+        p = atmosphereProfiles[i].params;
+        float k = trueScale ? 1.0f : ATMOSPHERE_EXAGGERATION;     // mesma profundidade óptica, camada mais grossa
+        p.topRadius = p.groundRadius + (p.topRadius - p.groundRadius) * k;
+        p.rayleighHeight *= k;
+        p.mieHeight *= k;
+        p.mie /= k;
+        for (int c = 0; c < 3; ++c) { p.rayleigh[c] /= k; p.absorption[c] /= k; }
+
+        lut.transmittance.resize((size_t)ATMO_T_W * ATMO_T_H * 3);
+        lut.scattering.resize((size_t)ATMO_S_R * ATMO_S_MU * ATMO_S_NU * ATMO_S_MUS * 4);
+        uint64_t checksum = packChecksum(&p, sizeof(p));
+        char path[128];
+        atmoCachePath(atmosphereProfiles[i].name, checksum, path, sizeof(path));
+        double t0 = nowMs();
+        bool cached = loadAtmosphereCache(lut, path, checksum);
+        if (!cached) {
+            startThreadPool();
+            parallelFor(ATMO_T_H, atmoBuildTransmittanceRow, &lut);          // o espalhamento lê a transmitância
+            parallelFor(ATMO_S_R * ATMO_S_MU, atmoBuildScatteringRow, &lut);
+            saveAtmosphereCache(lut, path, checksum);
+        }
+        printf("Atmosfera %s: %.1f ms (%s)\n", atmosphereProfiles[i].name, nowMs() - t0,
+               cached ? path : "calculada no pool de threads");
+
+        glGenTextures(1, &lut.transmittanceTex);
+        glBindTexture(GL_TEXTURE_2D, lut.transmittanceTex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, ATMO_T_W, ATMO_T_H, 0, GL_RGB, GL_FLOAT, lut.transmittance.data());
+        glGenTextures(1, &lut.scatteringTex);
+        glBindTexture(GL_TEXTURE_3D, lut.scatteringTex);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, ATMO_S_NU * ATMO_S_MUS, ATMO_S_MU, ATMO_S_R, 0, GL_RGBA, GL_FLOAT,
+                     lut.scattering.data());
+        std::vector<float>().swap(lut.scattering);     // só a GPU precisa delas daqui em diante
+        std::vector<float>().swap(lut.transmittance);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    atmosphereSphere = glGenLists(1);                   // esfera unitária da casca
+    glNewList(atmosphereSphere, GL_COMPILE);
+    GLUquadric* quad = gluNewQuadric();
+    gluSphere(quad, 1.0, 64, 32);
+    gluDeleteQuadric(quad);
+    glEndList();
+    return true;
+}
+
+// Cascas das atmosferas (depois dos planetas): soma a luz espalhada e
+// atenua o que está atrás pela transmitância (blend ONE, SRC_ALPHA)
+void drawAtmospheres(const BodyInstance* bodies, unsigned visible, const double origin[3]) {
+    if (!atmosphereProgram || !showAtmospheres) return;
+    TRACE_SCOPE("atmosferas");
+    glUseProgram(atmosphereProgram);
+    glUniform1f(atmoFcoefLoc, depthMode == DEPTH_LOG ? 1.0f / log2f(sceneFar + 1.0f) : 0.0f);
+    glUniform1i(atmoHdrLoc, hdrActive());
+    glUniform3f(atmoSunLoc, (float)(bodies[0].world[0] - origin[0]), (float)(bodies[0].world[1] - origin[1]),
+                (float)(bodies[0].world[2] - origin[2]));
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_CULL_FACE);
+    for (int i = 0; i < 8; ++i) {
+        int profile = planetAtmosphere[i];
+        if (profile < 0 || !(visible & (1u << (i + 1)))) continue;
+        const BodyInstance& b = bodies[i + 1];
+        const AtmosphereLut& lut = atmosphereLuts[profile];
+        const AtmosphereParams& p = lut.params;
+        float center[3] = {(float)(b.world[0] - origin[0]), (float)(b.world[1] - origin[1]), (float)(b.world[2] - origin[2])};
+        float kmPerUnit = p.groundRadius / b.radius;
+        float camDist = sqrtf(center[0]*center[0] + center[1]*center[1] + center[2]*center[2]) * kmPerUnit;
+        glCullFace(camDist > p.topRadius ? GL_BACK : GL_FRONT);        // de dentro, vê o lado interno
+        glUniform3fv(atmoCenterLoc, 1, center);
+        glUniform1f(atmoShellLoc, p.topRadius / kmPerUnit * 1.01f);     // circunscreve a esfera facetada
+        glUniform1f(atmoKmLoc, kmPerUnit);
+        glUniform1f(atmoGroundLoc, p.groundRadius);
+        glUniform1f(atmoTopLoc, p.topRadius);
+        glUniform3fv(atmoRayleighLoc, 1, p.rayleigh);
+        glUniform1f(atmoMieGLoc, p.mieG);
+        glUniform1f(atmoIntensityLoc, p.sunIntensity);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, lut.transmittanceTex);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_3D, lut.scatteringTex);
+        glCallList(atmosphereSphere);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glCullFace(GL_BACK);
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glUseProgram(sceneProgramActive ? sceneProgram : 0);
+}
@@ -0,0 +1,14 @@
+// Espalhamento atmosférico (Vênus e Terra) com tabelas pré-calculadas
+#ifndef SOLAR_ATMOSPHERE_H
+#define SOLAR_ATMOSPHERE_H
+
+#include "common.h"
+#include "bodies.h"
+
+extern bool useAtmosphere;   // --no-atmosphere desliga (não calcula as tabelas)
+extern bool showAtmospheres; // tecla 'A'
+
+bool initAtmosphere();
+void drawAtmospheres(const BodyInstance* bodies, unsigned visible, const double origin[3]);
+
+#endif
@@ -0,0 +1,293 @@
+#include "belts.h"
+
+#include "app.h"
+#include "bodies.h"
+#include "runtime.h"
+#include "stars.h"
+
+// ---------------------------------------------------------------------------
+// Cinturões de asteroides (entre Marte e Júpiter) e de Kuiper (além de
+// Netuno). Cada partícula guarda só os elementos orbitais; a posição é
+// resolvida a cada passo pela equação de Kepler, na GPU (transform feedback)
+// ou, no modo software, em lotes SSE de 4 partículas no pool de threads.
+// O movimento médio é um múltiplo inteiro de 1/BELT_MOTION_DIVISOR volta por
+// unidade de tempo, então a anomalia média sai de duas fases reduzidas em
+// double e não perde precisão com o tempo (como as órbitas dos planetas).
+
+const BeltSpec beltSpecs[BELTS] = {
+    {"asteroides", 3, 29.2f, 31.2f, 0.02f, 314000.0f, 494000.0f, 0.15f, 3.0f,
+     {0.003f, 0.015f}, {0.001f, 0.3f}, {0.55f, 0.5f, 0.45f}, 1.0f},
+    {"kuiper", 7, 78.0f, 100.0f, 0.05f, 4490000.0f, 7480000.0f, 0.15f, 10.0f,
+     {0.004f, 0.02f}, {0.02f, 0.6f}, {0.6f, 0.65f, 0.75f}, 0.5f},
+};
+const double BELT_MOTION_DIVISOR = 65536.0;   // voltas por unidade de tempo = motion / divisor
+
+Belt belts[BELTS];
+int beltParticles = 1 << 20;
+bool showBelts = true;
+
+struct BeltGenerateCtx {
+    int belt;
+    uint64_t seed;
+};
+
+// Cada partícula tem seu próprio gerador (seed, cinturão, índice): o
+// resultado não depende da ordem das tarefas
+void beltGenerateBatch(void* ctx, int batch) {
+    const BeltGenerateCtx& g = *(const BeltGenerateCtx*)ctx;
+    const BeltSpec& s = beltSpecs[g.belt];
+    Belt& b = belts[g.belt];
+    float innerA = trueScale ? s.trueInnerA : s.innerA, outerA = trueScale ? s.trueOuterA : s.outerA;
+    float maxE = trueScale ? s.trueMaxE : s.maxE;
+    const float* rad = trueScale ? s.trueRadius : s.radius;
+    int end = std::min(b.count, (batch + 1) * BELT_BATCH);
+    for (int i = batch * BELT_BATCH; i < end; ++i) {
+        uint64_t state = g.seed ^ ((uint64_t)g.belt << 56) ^ ((uint64_t)i * 0xD1B54A32D192ED03ULL);
+        float a = innerA + (outerA - innerA) * 0.5f * (uniform01(state) + uniform01(state));  // mais denso no meio
+        float e = maxE * uniform01(state);
+        double inc = s.maxIncDeg * M_PI / 180.0 * uniform01(state);
+        double node = 2.0 * M_PI * uniform01(state), peri = 2.0 * M_PI * uniform01(state);
+        double ci = cos(inc), si = sin(inc), cn = cos(node), sn = sin(node), cp = cos(peri), sp = sin(peri);
+        // P e Q no plano da eclíptica (x, z) com y para cima
+        float minor = a * sqrtf(1.0f - e * e);
+        b.px[i] = a * (float)(cn * cp - sn * sp * ci);
+        b.pz[i] = a * (float)(sn * cp + cn * sp * ci);
+        b.py[i] = a * (float)(sp * si);
+        b.qx[i] = minor * (float)(-cn * sp - sn * cp * ci);
+        b.qz[i] = minor * (float)(-sn * sp + cn * cp * ci);
+        b.qy[i] = minor * (float)(cp * si);
+        b.ecc[i] = e;
+        b.meanAnomaly[i] = uniform01(state);
+        double n = orbitSpeeds[s.refPlanet] * pow(a / orbitRadii[s.refPlanet], -1.5);   // rad por unidade de tempo
+        b.motion[i] = (float)std::max(1.0, floor(n / (2.0 * M_PI) * BELT_MOTION_DIVISOR + 0.5));
+        float u = uniform01(state);
+        b.radius[i] = rad[0] * powf(rad[1] / rad[0], u * u * u);                      // muitas pequenas, poucas grandes
+        b.albedo[i] = 0.5f + 0.5f * uniform01(state);
+    }
+}
+
+// Gera os elementos orbitais (uma vez; usado pelos dois renderizadores)
+void generateBelts() {
+    static bool generated = false;
+    if (generated || beltParticles <= 0) return;
+    generated = true;
+    TRACE_SCOPE("cinturoes: gerar");
+    startThreadPool();
+    double t0 = nowMs();
+    for (int k = 0; k < BELTS; ++k) {
+        Belt& b = belts[k];
+        b.count = ((int)(beltParticles * beltSpecs[k].share) + 3) & ~3;
+        std::vector<float>* arrays[] = {&b.px, &b.py, &b.pz, &b.qx, &b.qy, &b.qz, &b.ecc, &b.meanAnomaly, &b.motion,
+                                        &b.radius, &b.albedo};
+        for (size_t a = 0; a < sizeof(arrays) / sizeof(arrays[0]); ++a) arrays[a]->resize(b.count);
+        BeltGenerateCtx ctx = {k, (uint64_t)starSeed * 0x2545F4914F6CDD1DULL + 1};
+        parallelFor((b.count + BELT_BATCH - 1) / BELT_BATCH, beltGenerateBatch, &ctx);
+    }
+    printf("Cinturoes: %d asteroides + %d objetos de Kuiper (%.0f ms)\n", belts[0].count, belts[1].count, nowMs() - t0);
+}
+
+// Fases (em voltas) do tempo 'time' para motion = 64 * alto + baixo
+void beltPhases(double time, float* fine, float* coarse) {
+    *fine = (float)wrapPeriod(time / BELT_MOTION_DIVISOR, 1.0);
+    *coarse = (float)wrapPeriod(time * 64.0 / BELT_MOTION_DIVISOR, 1.0);
+}
+
+// ---------------------------------------------------------------------------
+// Cinturões na GPU. Os elementos ficam num VBO estático; a cada passo da
+// simulação um passe de transform feedback (sem rasterizar) resolve Kepler
+// para todas as partículas e grava as posições, relativas ao Sol, num segundo
+// VBO. O desenho usa point sprites com LOD pela distância: de perto a rocha é
+// um disco iluminado pelo Sol; abaixo de 2 pixels vira um ponto cujo brilho
+// cai com a área projetada.
+const int BELT_FLOATS = 11;             // perihelion(3) minor(3) orbit(3) look(2) por partícula
+const float BELT_MAX_POINT = 32.0f;     // diâmetro máximo do sprite (pixels)
+
+struct BeltRenderer {
+    bool ready = false;
+    GLuint elements[BELTS], positions[BELTS];
+    GLuint updateProgram = 0, drawProgram = 0;
+    GLint perihelionAttr, minorAttr, orbitAttr, positionAttr, lookAttr;
+    GLint phaseFineLoc, phaseCoarseLoc;
+    GLint sunOffsetLoc, colorLoc, pixelScaleLoc, minCoverageLoc, maxPointLoc, fcoefLoc;
+    unsigned long long updatedStep = ~0ULL;
+};
+BeltRenderer beltGL;
+
+const char* beltUpdateShader =
+    "#version 120\n"
+    "attribute vec3 perihelion;\n"          // a * P
+    "attribute vec3 minor;\n"               // b * Q
+    "attribute vec3 orbit;\n"               // e, M0 (voltas), movimento médio (inteiro)
+    "uniform float phaseFine, phaseCoarse;\n"
+    "varying vec3 position;\n"
+    "void main() {\n"
+    "    float hi = floor(orbit.z / 64.0), lo = orbit.z - hi * 64.0;\n"
+    "    float turns = fract(orbit.y + fract(hi * phaseCoarse) + fract(lo * phaseFine));\n"
+    "    float M = 6.2831853 * (turns < 0.5 ? turns : turns - 1.0);\n"
+    "    float e = orbit.x, E = M + e * sin(M);\n"
+    "    for (int k = 0; k < 2; ++k) E -= (E - e * sin(E) - M) / (1.0 - e * cos(E));\n"
+    "    position = perihelion * (cos(E) - e) + minor * sin(E);\n"
+    "    gl_Position = vec4(0.0);\n"
+    "}\n";
+
+const char* beltVertexShader =
+    "#version 120\n"
+    "attribute vec3 position;\n"            // relativa ao Sol (saída do transform feedback)
+    "attribute vec2 look;\n"                // raio, albedo
+    "uniform vec3 sunOffset, color;\n"      // Sol relativo à câmera
+    "uniform float pixelScale, minCoverage, maxPoint;\n"
+    "varying vec3 shade, lightEye;\n"
+    "varying float sprite, logz;\n"
+    "void main() {\n"
+    "    vec3 rel = sunOffset + position;\n"
+    "    vec4 eye = gl_ModelViewMatrix * vec4(rel, 1.0);\n"
+    "    gl_Position = gl_ProjectionMatrix * eye;\n"
+    "    logz = 1.0 + gl_Position.w;\n"
+    "    float diameter = 2.0 * look.x * pixelScale / max(-eye.z, 1e-6);\n"
+    "    gl_PointSize = clamp(diameter, 1.0, maxPoint);\n"
+    "    sprite = diameter >= 2.0 ? 1.0 : 0.0;\n"
+    "    lightEye = (gl_ModelViewMatrix * vec4(-position, 0.0)).xyz;\n"
+    "    float cosPhase = dot(normalize(-position), normalize(-rel));\n"
+    "    float coverage = max(min(diameter * diameter, 1.0), minCoverage);\n"
+    "    shade = color * look.y * (sprite > 0.0 ? 1.0 : coverage * (0.15 + 0.85 * (0.5 + 0.5 * cosPhase)));\n"
+    "}\n";
+
+const char* beltFragmentShader =
+    "#version 120\n"
+    "uniform float fcoef;\n"
+    "varying vec3 shade, lightEye;\n"
+    "varying float sprite, logz;\n"
+    "void main() {\n"
+    "    vec3 c = shade;\n"
+    "    if (sprite > 0.0) {\n"                  // disco com a normal de uma esfera
+    "        vec2 q = gl_PointCoord * 2.0 - 1.0;\n"
+    "        float r2 = dot(q, q);\n"
+    "        if (r2 > 1.0) discard;\n"
+    "        vec3 n = vec3(q.x, -q.y, sqrt(1.0 - r2));\n"
+    "        c *= 0.15 + 0.85 * max(dot(n, normalize(lightEye)), 0.0);\n"
+    "    }\n"
+    "    gl_FragColor = vec4(c, 1.0);\n"
+    "    gl_FragDepth = fcoef > 0.0 ? log2(logz) * fcoef : gl_FragCoord.z;\n"
+    "}\n";
+
+bool initBelts() {
+    if (beltParticles <= 0) return false;
+    BeltRenderer& br = beltGL;
+    const char* feedback[] = {"position"};
+    if (glVersion() < 30 || !(br.updateProgram = linkProgram(beltUpdateShader, NULL, feedback, 1))
+        || !(br.drawProgram = linkProgram(beltVertexShader, beltFragmentShader))) {
+        printf("Sem transform feedback (OpenGL 3.0): cinturoes so no modo software\n");
+        generateBelts();
+        return false;
+    }
+    br.perihelionAttr = glGetAttribLocation(br.updateProgram, "perihelion");
+    br.minorAttr = glGetAttribLocation(br.updateProgram, "minor");
+    br.orbitAttr = glGetAttribLocation(br.updateProgram, "orbit");
+    br.phaseFineLoc = glGetUniformLocation(br.updateProgram, "phaseFine");
+    br.phaseCoarseLoc = glGetUniformLocation(br.updateProgram, "phaseCoarse");
+    br.positionAttr = glGetAttribLocation(br.drawProgram, "position");
+    br.lookAttr = glGetAttribLocation(br.drawProgram, "look");
+    br.sunOffsetLoc = glGetUniformLocation(br.drawProgram, "sunOffset");
+    br.colorLoc = glGetUniformLocation(br.drawProgram, "color");
+    br.pixelScaleLoc = glGetUniformLocation(br.drawProgram, "pixelScale");
+    br.minCoverageLoc = glGetUniformLocation(br.drawProgram, "minCoverage");
+    br.maxPointLoc = glGetUniformLocation(br.drawProgram, "maxPoint");
+    br.fcoefLoc = glGetUniformLocation(br.drawProgram, "fcoef");
+
+    generateBelts();
+    glGenBuffers(BELTS, br.elements);
+    glGenBuffers(BELTS, br.positions);
+    size_t bytes = 0;
+    for (int k = 0; k < BELTS; ++k) {
+        const Belt& b = belts[k];
+        glBindBuffer(GL_ARRAY_BUFFER, br.elements[k]);
+        glBufferData(GL_ARRAY_BUFFER, (size_t)b.count * BELT_FLOATS * sizeof(float), NULL, GL_STATIC_DRAW);
+        float* dst = (float*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        for (int i = 0; dst && i < b.count; ++i, dst += BELT_FLOATS) {
+            const float v[BELT_FLOATS] = {b.px[i], b.py[i], b.pz[i], b.qx[i], b.qy[i], b.qz[i],
+                                          b.ecc[i], b.meanAnomaly[i], b.motion[i], b.radius[i], b.albedo[i]};
+            memcpy(dst, v, sizeof(v));
+        }
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, br.positions[k]);
+        glBufferData(GL_ARRAY_BUFFER, (size_t)b.count * 3 * sizeof(float), NULL, GL_DYNAMIC_COPY);
+        bytes += (size_t)b.count * (BELT_FLOATS + 3) * sizeof(float);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    br.ready = true;
+    printf("Cinturoes na GPU: %.1f MB em VBOs, posicoes por transform feedback\n", bytes / (1024.0 * 1024.0));
+    return true;
+}
+
+// Passe de transform feedback: só quando o tempo da simulação mudou
+void updateBelts() {
+    BeltRenderer& br = beltGL;
+    if (!br.ready || !showBelts || br.updatedStep == simSteps) return;
+    TRACE_SCOPE("cinturoes: Kepler");
+    gpuTimerBegin(GPU_PASS_BELTS);
+    br.updatedStep = simSteps;
+    float fine, coarse;
+    beltPhases(t, &fine, &coarse);
+    glUseProgram(br.updateProgram);
+    glUniform1f(br.phaseFineLoc, fine);
+    glUniform1f(br.phaseCoarseLoc, coarse);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glEnableVertexAttribArray(br.perihelionAttr);
+    glEnableVertexAttribArray(br.minorAttr);
+    glEnableVertexAttribArray(br.orbitAttr);
+    for (int k = 0; k < BELTS; ++k) {
+        const GLsizei stride = BELT_FLOATS * sizeof(float);
+        glBindBuffer(GL_ARRAY_BUFFER, br.elements[k]);
+        glVertexAttribPointer(br.perihelionAttr, 3, GL_FLOAT, GL_FALSE, stride, (const void*)0);
+        glVertexAttribPointer(br.minorAttr, 3, GL_FLOAT, GL_FALSE, stride, (const void*)(3 * sizeof(float)));
+        glVertexAttribPointer(br.orbitAttr, 3, GL_FLOAT, GL_FALSE, stride, (const void*)(6 * sizeof(float)));
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, br.positions[k]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, belts[k].count);
+        glEndTransformFeedback();
+    }
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisableVertexAttribArray(br.perihelionAttr);
+    glDisableVertexAttribArray(br.minorAttr);
+    glDisableVertexAttribArray(br.orbitAttr);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    glUseProgram(0);
+    gpuTimerEnd();
+}
+
+// Desenha os cinturões numa vista (câmera na origem, Sol em -origin)
+void drawBelts(const View& v, const double origin[3]) {
+    BeltRenderer& br = beltGL;
+    if (!br.ready || !showBelts) return;
+    TRACE_SCOPE("cinturoes");
+    glUseProgram(br.drawProgram);
+    glUniform3f(br.sunOffsetLoc, (float)-origin[0], (float)-origin[1], (float)-origin[2]);
+    glUniform1f(br.pixelScaleLoc, v.h / (2.0f * tanf(v.fovy * 0.5f * (float)M_PI / 180.0f)));
+    glUniform1f(br.minCoverageLoc, BELT_MIN_COVERAGE);
+    glUniform1f(br.maxPointLoc, BELT_MAX_POINT * renderScale);
+    glUniform1f(br.fcoefLoc, depthMode == DEPTH_LOG ? 1.0f / log2f(sceneFar + 1.0f) : 0.0f);
+    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+    glEnable(GL_POINT_SPRITE);
+    glEnable(GL_BLEND);                                 // soma: o lado noturno não tapa o que está atrás
+    glBlendFunc(GL_ONE, GL_ONE);
+    glDepthMask(GL_FALSE);
+    glEnableVertexAttribArray(br.positionAttr);
+    glEnableVertexAttribArray(br.lookAttr);
+    for (int k = 0; k < BELTS; ++k) {
+        glUniform3fv(br.colorLoc, 1, beltSpecs[k].color);
+        glBindBuffer(GL_ARRAY_BUFFER, br.positions[k]);
+        glVertexAttribPointer(br.positionAttr, 3, GL_FLOAT, GL_FALSE, 0, (const void*)0);
+        glBindBuffer(GL_ARRAY_BUFFER, br.elements[k]);
+        glVertexAttribPointer(br.lookAttr, 2, GL_FLOAT, GL_FALSE, BELT_FLOATS * sizeof(float), (const void*)(9 * sizeof(float)));
+        glDrawArrays(GL_POINTS, 0, belts[k].count);
+    }
+    glDisableVertexAttribArray(br.positionAttr);
+    glDisableVertexAttribArray(br.lookAttr);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glDisable(GL_POINT_SPRITE);
+    glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+    glUseProgram(sceneProgramActive ? sceneProgram : 0);
+}
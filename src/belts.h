@@ -0,0 +1,112 @@
+// Cinturões de asteroides e de Kuiper: elementos orbitais na CPU, posições
+// por Kepler em lotes SSE (software) ou por transform feedback (GPU)
+#ifndef SOLAR_BELTS_H
+#define SOLAR_BELTS_H
+
+#include "common.h"
+#include <emmintrin.h>
+#include "render.h"
+
+struct BeltSpec {
+    const char* name;
+    int refPlanet;                      // velocidade pela 3ª lei de Kepler a partir deste planeta
+    float innerA, outerA, maxE;         // semieixo maior e excentricidade (escala comprimida)
+    float trueInnerA, trueOuterA, trueMaxE;   // escala real (1000 km)
+    float maxIncDeg;
+    float radius[2], trueRadius[2];     // raio das rochas (mínimo, máximo)
+    float color[3];
+    float share;                        // fração de --belt=N
+};
+
+const int BELTS = 2;
+extern const BeltSpec beltSpecs[BELTS];
+
+const int BELT_BATCH = 4096;                  // partículas por tarefa do pool
+const float BELT_MIN_COVERAGE = 0.02f;        // brilho mínimo de uma rocha menor que um pixel (senão o cinturão some de longe)
+
+// Estrutura de arrays (lotes SSE); count é múltiplo de 4
+struct Belt {
+    int count = 0;
+    std::vector<float> px, py, pz;      // a * P (direção do periélio)
+    std::vector<float> qx, qy, qz;      // b * Q (b = a sqrt(1 - e^2))
+    std::vector<float> ecc, meanAnomaly, motion;   // e, M0 (voltas), movimento médio (inteiro)
+    std::vector<float> radius, albedo;
+};
+
+extern Belt belts[BELTS];
+extern int beltParticles; // --belt=N (asteroides; Kuiper recebe a metade; 0 desliga)
+extern bool showBelts;    // tecla 'b'
+
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline float uniform01(uint64_t& state) {
+    return (splitMix64(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+void generateBelts();
+void beltPhases(double time, float* fine, float* coarse);
+
+inline __m128 sseFract(__m128 x) {                  // x >= 0
+    return _mm_sub_ps(x, _mm_cvtepi32_ps(_mm_cvttps_epi32(x)));
+}
+
+// Seno e cosseno de 4 ângulos em torno de [-pi, pi] (Taylor até x^15 / x^16)
+inline void sseSinCos(__m128 x, __m128* s, __m128* c) {
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 ps = _mm_set1_ps(-7.6471637e-13f);
+    ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(1.6059044e-10f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(-2.5052108e-8f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(2.7557319e-6f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(-1.9841270e-4f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(8.3333333e-3f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(-1.6666667e-1f));
+    *s = _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(ps, x2), x));
+    __m128 pc = _mm_set1_ps(4.7794773e-14f);
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(-1.1470746e-11f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(2.0876757e-9f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(-2.7557319e-7f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(2.4801587e-5f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(-1.3888889e-3f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(4.1666667e-2f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(-0.5f));
+    *c = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(pc, x2));
+}
+
+// Posições (relativas ao Sol) das partículas [first, first + 4) — mesma conta
+// do shader de transform feedback
+inline void beltPositions4(const Belt& b, int first, __m128 fine, __m128 coarse, __m128* x, __m128* y, __m128* z) {
+    const __m128 one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f), twoPi = _mm_set1_ps(6.2831853f);
+    __m128 motion = _mm_loadu_ps(&b.motion[first]);
+    __m128 hi = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(motion, _mm_set1_ps(1.0f / 64.0f))));
+    __m128 lo = _mm_sub_ps(motion, _mm_mul_ps(hi, _mm_set1_ps(64.0f)));
+    __m128 turns = _mm_add_ps(_mm_loadu_ps(&b.meanAnomaly[first]),
+                              _mm_add_ps(sseFract(_mm_mul_ps(hi, coarse)), sseFract(_mm_mul_ps(lo, fine))));
+    turns = sseFract(turns);
+    turns = _mm_sub_ps(turns, _mm_and_ps(_mm_cmpge_ps(turns, half), one));    // [-0.5, 0.5)
+    __m128 M = _mm_mul_ps(turns, twoPi);
+    __m128 e = _mm_loadu_ps(&b.ecc[first]);
+    __m128 s, c;
+    sseSinCos(M, &s, &c);
+    __m128 E = _mm_add_ps(M, _mm_mul_ps(e, s));
+    for (int k = 0; k < 2; ++k) {                   // Newton: e pequeno, duas iterações bastam
+        sseSinCos(E, &s, &c);
+        __m128 f = _mm_sub_ps(_mm_sub_ps(E, _mm_mul_ps(e, s)), M);
+        E = _mm_sub_ps(E, _mm_div_ps(f, _mm_sub_ps(one, _mm_mul_ps(e, c))));
+    }
+    sseSinCos(E, &s, &c);
+    __m128 u = _mm_sub_ps(c, e);
+    *x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&b.px[first]), u), _mm_mul_ps(_mm_loadu_ps(&b.qx[first]), s));
+    *y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&b.py[first]), u), _mm_mul_ps(_mm_loadu_ps(&b.qy[first]), s));
+    *z = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&b.pz[first]), u), _mm_mul_ps(_mm_loadu_ps(&b.qz[first]), s));
+}
+
+bool initBelts();
+void updateBelts();
+void drawBelts(const View& v, const double origin[3]);
+
+#endif
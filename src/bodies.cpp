@@ -0,0 +1,431 @@
+#include "bodies.h"
+
+#include <emmintrin.h>
+
+#include "app.h"
+#include "camera.h"
+#include "render.h"
+
+// Configuração das órbitas e planetas
+float orbitRadii[]  = {16.0f, 20.0f, 24.0f, 28.0f, 35.0f, 48.0f, 60.0f, 72.0f};
+float orbitSpeeds[] = {0.6f, 0.55f, 0.5f, 0.45f, 0.3f, 0.25f, 0.2f, 0.15f};
+
+// Tamanhos dos planetas
+float planetSizes[] = {0.75f, 1.35f, 1.5f, 0.9f, 4.5f, 5.25f, 3.2f, 3.0f};     // raio de cada planeta
+
+// Catálogo em escala real (km / 1000): raio médio e semieixo maior
+const float TRUE_SUN_RADIUS = 696.0f;
+const float trueOrbitRadii[8]  = {57909.0f, 108209.0f, 149598.0f, 227939.0f,
+                                  778570.0f, 1433530.0f, 2872460.0f, 4495060.0f};
+const float truePlanetSizes[8] = {2.440f, 6.052f, 6.371f, 3.390f, 69.911f, 58.232f, 25.362f, 24.622f};
+
+// Rotação própria
+float rotationSpeed[8]  = {2.0f,1.8f,1.6f,1.5f,1.2f,1.1f,1.0f,0.9f};
+bool trueScale = false;
+float sunRadius = 10.0f;
+
+// --true-scale: troca o catálogo comprimido pelo real (1 unidade = 1000 km)
+void applyTrueScale() {
+    trueScale = true;
+    sunRadius = TRUE_SUN_RADIUS;
+    for (int i = 0; i < 8; ++i) {
+        orbitRadii[i] = trueOrbitRadii[i];
+        planetSizes[i] = truePlanetSizes[i];
+    }
+    sceneNear = 0.01f;             // 10 m
+    sceneFar = 1e8f;               // além de Netuno (4,5e6)
+    orbitCameraScale = 6e4f;       // órbita padrão (90 unidades) passa a enquadrar o sistema todo
+    lightLinearAtt = lightQuadraticAtt = 0.0f;   // nessas distâncias a atenuação apagaria tudo
+}
+
+// ---------------------------------------------------------------------------
+// ECS por arquétipos: uma entidade é só um id; a máscara dos componentes que
+// ela tem define o seu arquétipo, e cada arquétipo guarda cada componente num
+// vetor contíguo (uma linha por entidade). Os sistemas pedem uma máscara e
+// percorrem as colunas densas dos arquétipos que a contêm, sem testes por
+// índice de corpo ("se for Saturno, desenha o anel").
+
+const size_t componentSize[COMPONENT_TYPES] = {sizeof(Orbit), sizeof(Spin), sizeof(Render),
+                                               sizeof(Ring), sizeof(Light), sizeof(Camera)};
+
+// Entidade nova com os componentes da máscara zerados (preencher com ecsGet)
+Entity ecsCreate(EcsWorld& w, unsigned mask) {
+    int a = 0;
+    while (a < (int)w.archetypes.size() && w.archetypes[a].mask != mask) ++a;
+    if (a == (int)w.archetypes.size()) {
+        w.archetypes.push_back(Archetype());
+        w.archetypes[a].mask = mask;
+    }
+    Archetype& arch = w.archetypes[a];
+    Entity e = (Entity)w.archetypeOf.size();
+    w.archetypeOf.push_back(a);
+    w.rowOf.push_back(arch.size());
+    arch.entities.push_back(e);
+    for (int c = 0; c < COMPONENT_TYPES; ++c)
+        if (mask & (1u << c)) arch.columns[c].resize(arch.columns[c].size() + componentSize[c], 0);
+    return e;
+}
+
+// Chama f(arquétipo) para cada arquétipo não vazio que tem todos os componentes da máscara
+template<class F> void ecsEach(EcsWorld& w, unsigned mask, F f) {
+    for (size_t a = 0; a < w.archetypes.size(); ++a)
+        if ((w.archetypes[a].mask & mask) == mask && !w.archetypes[a].entities.empty()) f(w.archetypes[a]);
+}
+
+// Origem flutuante: as posições em float (renderizadores em CPU) são
+// relativas a worldOrigin, que é movida para perto da câmera quando ela se
+// afasta mais que ORIGIN_REBASE_DISTANCE. O GL usa offsets relativos ao olho.
+double worldOrigin[3] = {0, 0, 0};
+const double ORIGIN_REBASE_DISTANCE = 1.0e4;
+
+void updateFloatingOrigin(const double eye[3]) {
+    double d2 = 0.0;
+    for (int k = 0; k < 3; ++k) d2 += (eye[k] - worldOrigin[k]) * (eye[k] - worldOrigin[k]);
+    if (d2 > ORIGIN_REBASE_DISTANCE * ORIGIN_REBASE_DISTANCE)
+        for (int k = 0; k < 3; ++k) worldOrigin[k] = eye[k];
+}
+
+// ---------------------------------------------------------------------------
+// Grafo de cena plano: nós em arrays, pai antes do filho e em pré-ordem, então
+// a subárvore do nó i é o intervalo [i, subtreeEnd[i]). Cada nó guarda a
+// rotação local em float (3 colunas SSE) e a translação em double (dois
+// __m128d, para a escala real); as transformações de mundo saem numa passada
+// linear, sem recursão. Mudar a local de um nó marca os ancestrais
+// (subtreeDirty): subárvores limpas cujo pai não mudou são puladas inteiras.
+
+// Nó novo (identidade); o pai precisa já existir. Depois de montar, sgFinalize.
+int sgAddNode(SceneGraph& g, int parent) {
+    int i = g.count++;
+    const SgRot identity = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0}};
+    const SgPos origin = {{0, 0, 0, 0}};
+    g.parent.push_back(parent);
+    g.subtreeEnd.push_back(i + 1);
+    g.localRot.push_back(identity);
+    g.worldRot.push_back(identity);
+    g.localPos.push_back(origin);
+    g.worldPos.push_back(origin);
+    g.localDirty.push_back(1);
+    g.subtreeDirty.push_back(1);
+    g.changed.push_back(1);
+    return i;
+}
+
+// Reordena em pré-ordem (filhos na ordem de criação) e calcula subtreeEnd.
+// remap[antigo] = novo índice.
+void sgFinalize(SceneGraph& g, std::vector<int>& remap) {
+    int n = g.count;
+    std::vector<int> childCount(n + 1, 0), children(n), order, stack;
+    for (int i = 0; i < n; ++i) childCount[g.parent[i] + 1]++;           // raízes no balde 0
+    std::vector<int> start(n + 2, 0);
+    for (int i = 0; i <= n; ++i) start[i + 1] = start[i] + childCount[i];
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int i = 0; i < n; ++i) children[fill[g.parent[i] + 1]++] = i;
+    order.reserve(n);
+    for (int r = start[1] - 1; r >= start[0]; --r) stack.push_back(children[r]);
+    while (!stack.empty()) {
+        int i = stack.back();
+        stack.pop_back();
+        order.push_back(i);
+        for (int c = start[i + 2] - 1; c >= start[i + 1]; --c) stack.push_back(children[c]);
+    }
+    remap.assign(n, 0);
+    for (int i = 0; i < n; ++i) remap[order[i]] = i;
+
+    SceneGraph s = g;
+    for (int i = 0; i < n; ++i) {
+        int o = order[i];
+        g.parent[i] = s.parent[o] < 0 ? -1 : remap[s.parent[o]];
+        g.subtreeEnd[i] = i + 1;
+        g.localRot[i] = s.localRot[o];
+        g.worldRot[i] = s.worldRot[o];
+        g.localPos[i] = s.localPos[o];
+        g.worldPos[i] = s.worldPos[o];
+        g.localDirty[i] = g.subtreeDirty[i] = g.changed[i] = 1;
+    }
+    for (int i = n - 1; i >= 0; --i)                   // filhos antes dos pais
+        if (g.parent[i] >= 0) g.subtreeEnd[g.parent[i]] = std::max(g.subtreeEnd[g.parent[i]], g.subtreeEnd[i]);
+}
+
+// rot: 3x3 em colunas (como glMultMatrix); pos em double
+void sgSetLocal(SceneGraph& g, int i, const float rot[9], const double pos[3]) {
+    SgRot& r = g.localRot[i];
+    for (int k = 0; k < 3; ++k) {
+        r.col[k * 4] = rot[k * 3]; r.col[k * 4 + 1] = rot[k * 3 + 1]; r.col[k * 4 + 2] = rot[k * 3 + 2];
+    }
+    SgPos& p = g.localPos[i];
+    p.p[0] = pos[0]; p.p[1] = pos[1]; p.p[2] = pos[2];
+    g.localDirty[i] = 1;
+    for (int j = i; j >= 0 && !g.subtreeDirty[j]; j = g.parent[j]) g.subtreeDirty[j] = 1;
+}
+
+void sgUpdate(SceneGraph& g) {
+    int updated = 0;
+    for (int i = 0; i < g.count; ) {
+        int p = g.parent[i];
+        bool inherit = p >= 0 && g.changed[p];
+        if (!inherit && !g.subtreeDirty[i]) {          // nada mudou aqui embaixo
+            i = g.subtreeEnd[i];
+            continue;
+        }
+        bool changed = inherit || g.localDirty[i];
+        g.changed[i] = changed;
+        g.localDirty[i] = g.subtreeDirty[i] = 0;
+        if (changed) {
+            if (p < 0) {
+                g.worldRot[i] = g.localRot[i];
+                g.worldPos[i] = g.localPos[i];
+            } else {
+                const float* L = g.localRot[i].col;
+                const float* Pr = g.worldRot[p].col;
+                float* W = g.worldRot[i].col;
+                __m128 P0 = _mm_load_ps(Pr), P1 = _mm_load_ps(Pr + 4), P2 = _mm_load_ps(Pr + 8);
+                for (int k = 0; k < 3; ++k) {               // W = P * L, coluna a coluna
+                    __m128 l = _mm_load_ps(L + k * 4);
+                    _mm_store_ps(W + k * 4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(P0, _mm_shuffle_ps(l, l, 0x00)),
+                                                                  _mm_mul_ps(P1, _mm_shuffle_ps(l, l, 0x55))),
+                                                       _mm_mul_ps(P2, _mm_shuffle_ps(l, l, 0xAA))));
+                }
+                // translação em double: pai + P * local
+                const double* lp = g.localPos[i].p;
+                const double* pp = g.worldPos[p].p;
+                __m128d lo = _mm_load_pd(pp), hi = _mm_load_pd(pp + 2);
+                __m128 cols[3] = {P0, P1, P2};
+                for (int k = 0; k < 3; ++k) {
+                    __m128d s = _mm_set1_pd(lp[k]);
+                    lo = _mm_add_pd(lo, _mm_mul_pd(_mm_cvtps_pd(cols[k]), s));
+                    hi = _mm_add_pd(hi, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(cols[k], cols[k])), s));
+                }
+                _mm_store_pd(g.worldPos[i].p, lo);
+                _mm_store_pd(g.worldPos[i].p + 2, hi);
+            }
+            updated++;
+        }
+        ++i;
+    }
+    g.updated = updated;
+}
+
+void sgWorld(const SceneGraph& g, int i, double pos[3], float rot[9]) {
+    const SgPos& p = g.worldPos[i];
+    const SgRot& r = g.worldRot[i];
+    for (int k = 0; k < 3; ++k) {
+        pos[k] = p.p[k];
+        rot[k * 3] = r.col[k * 4]; rot[k * 3 + 1] = r.col[k * 4 + 1]; rot[k * 3 + 2] = r.col[k * 4 + 2];
+    }
+}
+
+// Rotações 3x3 em colunas com a convenção do glRotatef
+void rot3Y(float deg, float out[9]) {
+    float a = deg * (float)M_PI / 180.0f, c = cosf(a), s = sinf(a);
+    const float r[9] = {c, 0, -s, 0, 1, 0, s, 0, c};
+    memcpy(out, r, sizeof(r));
+}
+
+void rot3X(float deg, float out[9]) {
+    float a = deg * (float)M_PI / 180.0f, c = cosf(a), s = sinf(a);
+    const float r[9] = {1, 0, 0, 0, c, s, 0, -s, c};
+    memcpy(out, r, sizeof(r));
+}
+
+// ---------------------------------------------------------------------------
+// Luas: a Lua, as galileanas e Titã, em órbitas circulares no plano do
+// equador do planeta (inclinado em x) e com rotação sincronizada (a mesma
+// face voltada para o planeta). Não há textura: são esferas com a cor média.
+struct MoonSpec {
+    const char* name;
+    int planet;                         // 0..7
+    float orbit, radius;                // escala comprimida
+    float trueOrbit, trueRadius;        // escala real (1000 km)
+    float speed;                        // rad por unidade de tempo
+    float inclinationDeg;
+    float color[3];
+};
+const MoonSpec moonSpecs[NUM_MOONS] = {
+    {"lua",       2, 2.6f, 0.40f,  384.4f, 1.737f, 1.5f, 5.1f, {0.72f, 0.70f, 0.68f}},
+    {"io",        4, 6.0f, 0.35f,  421.7f, 1.822f, 2.0f, 0.0f, {0.90f, 0.80f, 0.40f}},
+    {"europa",    4, 7.0f, 0.30f,  671.0f, 1.561f, 1.4f, 0.5f, {0.85f, 0.78f, 0.68f}},
+    {"ganimedes", 4, 8.3f, 0.50f, 1070.4f, 2.634f, 1.0f, 0.2f, {0.60f, 0.56f, 0.50f}},
+    {"calisto",   4, 10.0f, 0.45f, 1882.7f, 2.410f, 0.6f, 0.3f, {0.42f, 0.38f, 0.34f}},
+    {"tita",      5, 10.5f, 0.50f, 1221.9f, 2.575f, 0.8f, 0.3f, {0.85f, 0.65f, 0.35f}},
+};
+
+float moonOrbit(int m)  { return trueScale ? moonSpecs[m].trueOrbit : moonSpecs[m].orbit; }
+float moonRadius(int m) { return trueScale ? moonSpecs[m].trueRadius : moonSpecs[m].radius; }
+
+// Anéis do catálogo (outer = 0: sem anel)
+const Ring planetRings[8] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},
+                             {0, 0, 0}, {1.3f, 1.6f, 30.0f}, {0, 0, 0}, {0, 0, 0}};
+
+// Ângulo na órbita no tempo 'time', reduzido a [0, 2pi)
+double orbitAngleOf(const Orbit& o, double time) {
+    return wrapPeriod(time * o.speed + o.phase, 2.0 * M_PI);
+}
+
+// Posição relativa ao pai e direção do movimento (mesma conta do grafo, em double)
+void orbitOffset(const Orbit& o, double time, double out[3], float tangent[3]) {
+    double a = orbitAngleOf(o, time);
+    double inc = o.inclinationDeg * M_PI / 180.0, ci = cos(inc), si = sin(inc);
+    double x = o.radius * cos(a), z = o.radius * sin(a);
+    out[0] = x; out[1] = -si * z; out[2] = ci * z;
+    if (tangent) {
+        tangent[0] = (float)-sin(a); tangent[1] = (float)(-si * cos(a)); tangent[2] = (float)(ci * cos(a));
+    }
+}
+
+// Rotação própria em graus no passo 'steps' (sincronizada: acompanha o ângulo da órbita)
+float spinAngle(const Spin& sp, const Orbit* o, double steps, double time) {
+    if (sp.synchronous && o) return (float)(-orbitAngleOf(*o, time) * 180.0 / M_PI);
+    return (float)wrapPeriod(steps * (double)sp.degPerStep, 360.0);
+}
+
+SolarSystem solarSystem;
+
+// Entidade que orbita 'parent', já com os nós do grafo
+Entity addOrbiter(SolarSystem& s, Entity parent, const Ring& ring, const Orbit& orbit, const Spin& spin,
+                  const Render& render) {
+    unsigned mask = compBit<Orbit>() | compBit<Spin>() | compBit<Render>() | compBit<Camera>();
+    if (ring.outer > 0) mask |= compBit<Ring>();
+    Entity e = ecsCreate(s.ecs, mask);
+    const Orbit* around = ecsGet<Orbit>(s.ecs, parent);
+    Orbit* o = ecsGet<Orbit>(s.ecs, e);
+    *o = orbit;
+    o->parent = parent;
+    o->plane = sgAddNode(s.g, around ? around->node : s.root);
+    o->node = sgAddNode(s.g, o->plane);
+    Spin* sp = ecsGet<Spin>(s.ecs, e);
+    *sp = spin;
+    sp->node = sgAddNode(s.g, o->node);
+    Render* r = ecsGet<Render>(s.ecs, e);
+    *r = render;
+    r->node = sp->node;
+    ecsGet<Camera>(s.ecs, e)->surfaceHeight = 1.25f;
+    if (ring.outer > 0) *ecsGet<Ring>(s.ecs, e) = ring;
+    s.slotEntity[render.slot] = e;
+    return e;
+}
+
+void buildSolarSystem() {
+    SolarSystem& s = solarSystem;
+    s.root = sgAddNode(s.g, -1);
+    s.sun = ecsCreate(s.ecs, compBit<Render>() | compBit<Light>() | compBit<Camera>());
+    const Render sunRender = {0, sgAddNode(s.g, s.root), sunRadius, 0, {1.0f, 1.0f, 1.0f}};
+    const Light light = {{0.2f, 0.2f, 0.2f}, {2.5f, 2.5f, 2.0f}, {1.5f, 1.5f, 1.5f}, {1.5f, 1.5f, 1.0f}};
+    *ecsGet<Render>(s.ecs, s.sun) = sunRender;
+    *ecsGet<Light>(s.ecs, s.sun) = light;
+    ecsGet<Camera>(s.ecs, s.sun)->surfaceHeight = 1.25f;
+    s.slotEntity[0] = s.sun;
+
+    for (int i = 0; i < 8; ++i) {
+        const Orbit orbit = {s.sun, orbitRadii[i], orbitSpeeds[i], 0.0, 0.0f, -1, -1};
+        const Spin spin = {rotationSpeed[i], false, -1};
+        const Render render = {1 + i, -1, planetSizes[i], 1 + i, {1.0f, 1.0f, 1.0f}};
+        addOrbiter(s, s.sun, planetRings[i], orbit, spin, render);
+    }
+    const Ring noRing = {0, 0, 0};
+    for (int m = 0; m < NUM_MOONS; ++m) {
+        const MoonSpec& ms = moonSpecs[m];
+        const Orbit orbit = {-1, moonOrbit(m), ms.speed, m * 1.7, ms.inclinationDeg, -1, -1};
+        const Spin spin = {0.0f, true, -1};
+        const Render render = {9 + m, -1, moonRadius(m), -1, {ms.color[0], ms.color[1], ms.color[2]}};
+        addOrbiter(s, s.slotEntity[1 + ms.planet], noRing, orbit, spin, render);
+    }
+
+    // pré-ordem do grafo: renumera os nós guardados nos componentes
+    std::vector<int> remap;
+    sgFinalize(s.g, remap);
+    s.root = remap[s.root];
+    ecsEach(s.ecs, compBit<Render>(), [&](Archetype& a) {
+        Render* r = a.column<Render>();
+        for (int i = 0; i < a.size(); ++i) r[i].node = remap[r[i].node];
+    });
+    ecsEach(s.ecs, compBit<Spin>(), [&](Archetype& a) {
+        Spin* sp = a.column<Spin>();
+        for (int i = 0; i < a.size(); ++i) sp[i].node = remap[sp[i].node];
+    });
+    ecsEach(s.ecs, compBit<Orbit>(), [&](Archetype& a) {
+        Orbit* o = a.column<Orbit>();
+        for (int i = 0; i < a.size(); ++i) {
+            o[i].plane = remap[o[i].plane];
+            o[i].node = remap[o[i].node];
+            float tilt[9];
+            const double none[3] = {0, 0, 0};
+            rot3X(o[i].inclinationDeg, tilt);
+            sgSetLocal(s.g, o[i].plane, tilt, none);
+        }
+    });
+}
+
+SolarSystem& solarEntities() {
+    if (solarSystem.g.count == 0) buildSolarSystem();
+    return solarSystem;
+}
+
+Entity bodyEntity(int slot) {
+    return solarEntities().slotEntity[slot];
+}
+
+const Light& sunLight() {
+    SolarSystem& s = solarEntities();
+    return *ecsGet<Light>(s.ecs, s.sun);
+}
+
+// Sistemas: cada um percorre as colunas densas dos arquétipos que têm os
+// seus componentes e escreve as locais do grafo (ou as instâncias)
+void orbitSystem(SolarSystem& s, double time) {
+    float identity[9];
+    rot3Y(0.0f, identity);
+    ecsEach(s.ecs, compBit<Orbit>(), [&](Archetype& a) {
+        const Orbit* o = a.column<Orbit>();
+        for (int i = 0; i < a.size(); ++i) {
+            double angle = orbitAngleOf(o[i], time);
+            double pos[3] = {o[i].radius * cos(angle), 0.0, o[i].radius * sin(angle)};
+            sgSetLocal(s.g, o[i].node, identity, pos);
+        }
+    });
+}
+
+void spinSystem(SolarSystem& s, unsigned long long steps, double time) {
+    ecsEach(s.ecs, compBit<Spin>(), [&](Archetype& a) {
+        const Spin* sp = a.column<Spin>();
+        const Orbit* o = a.has<Orbit>() ? a.column<Orbit>() : NULL;
+        const double none[3] = {0, 0, 0};
+        float rot[9];
+        for (int i = 0; i < a.size(); ++i) {
+            rot3Y(spinAngle(sp[i], o ? &o[i] : NULL, (double)steps, time), rot);
+            sgSetLocal(s.g, sp[i].node, rot, none);
+        }
+    });
+}
+
+int renderSystem(SolarSystem& s, BodyInstance out[NUM_BODIES]) {
+    int count = 0;
+    ecsEach(s.ecs, compBit<Render>(), [&](Archetype& a) {
+        const Render* r = a.column<Render>();
+        const Ring* ring = a.has<Ring>() ? a.column<Ring>() : NULL;
+        for (int i = 0; i < a.size(); ++i) {
+            BodyInstance& b = out[r[i].slot];
+            sgWorld(s.g, r[i].node, b.world, b.rot);
+            for (int k = 0; k < 3; ++k) b.pos[k] = (float)(b.world[k] - worldOrigin[k]);
+            b.radius = r[i].radius;
+            b.texture = r[i].texture;
+            for (int k = 0; k < 3; ++k) b.tint[k] = r[i].tint[k];
+            b.emissive = a.has<Light>();
+            b.hasRing = ring != NULL;
+            if (ring) b.ring = ring[i];
+            count = std::max(count, r[i].slot + 1);
+        }
+    });
+    return count;
+}
+
+// Sistemas do passo atual (o grafo só refaz o que mudou) + extração das instâncias
+int computeBodies(BodyInstance out[NUM_BODIES]) {
+    SolarSystem& s = solarEntities();
+    if (s.step != simSteps) {
+        s.step = simSteps;
+        orbitSystem(s, t);
+        spinSystem(s, simSteps, t);
+        sgUpdate(s.g);
+    }
+    return renderSystem(s, out);
+}
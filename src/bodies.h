@@ -0,0 +1,167 @@
+// Corpos do sistema solar: catálogo das órbitas, ECS por arquétipos, grafo
+// de cena plano, luas e os sistemas que produzem as BodyInstance do quadro
+#ifndef SOLAR_BODIES_H
+#define SOLAR_BODIES_H
+
+#include "common.h"
+
+// Catálogo das órbitas (comprimido; --true-scale troca pelo real)
+extern float orbitRadii[];      // raios das órbitas
+extern float orbitSpeeds[];     // velocidade angular
+extern float rotationSpeed[8];  // vel. rotação
+extern bool trueScale;          // --true-scale
+extern float sunRadius;
+
+void applyTrueScale();
+
+// ECS por arquétipos: entidade = id, arquétipo = máscara de componentes.
+// Só os corpos (Sol, planetas, luas) são entidades. As partículas dos
+// cinturões (belts[], até milhões) e das caudas dos cometas (cometPool[])
+// ficam fora: não têm hierarquia, são avaliadas em lotes SSE ou por
+// transform feedback a partir dos elementos orbitais, e as das caudas nascem
+// e morrem a cada passo; como entidades, cada uma custaria um nó do grafo e
+// uma linha de arquétipo. A câmera também não é entidade (o estado é o
+// camRig); o componente Camera só marca os corpos que ela pode seguir.
+enum ComponentType { COMP_ORBIT = 0, COMP_SPIN, COMP_RENDER, COMP_RING, COMP_LIGHT, COMP_CAMERA, COMPONENT_TYPES };
+typedef int Entity;
+
+struct Orbit {                 // órbita circular em torno de outra entidade
+    Entity parent;             // -1 = origem (o Sol)
+    double radius;
+    double speed;              // rad por unidade de tempo
+    double phase;              // rad em t = 0
+    float inclinationDeg;      // plano da órbita inclinado em x em relação ao do pai
+    int plane, node;           // nós do grafo: plano (fixo) e posição na órbita
+};
+
+struct Spin {                  // rotação própria em y
+    float degPerStep;
+    bool synchronous;          // sincronizada com a órbita: a mesma face voltada para o pai
+    int node;                  // nó do grafo do corpo
+};
+
+struct Render {                // esfera desenhada
+    int slot;                  // índice em BodyInstance (0 = Sol, 1..8 = planetas, 9.. = luas)
+    int node;
+    float radius;
+    int texture;               // índice em cpuTextures (-1 = sem textura, usa tint)
+    float tint[3];
+};
+
+struct Ring {                  // anel plano em volta do corpo
+    float inner, outer;        // em raios do corpo
+    float tiltDeg;             // inclinação em x (não gira com o corpo)
+};
+
+struct Light {                 // fonte de luz pontual no centro do corpo (GL_LIGHT0)
+    float ambient[3], diffuse[3], specular[3];
+    float emission[3];         // material do próprio corpo
+};
+
+struct Camera {                // corpo que a câmera pode seguir ([ e ])
+    float surfaceHeight;       // olho no modo superfície, em raios do corpo
+};
+
+template<class T> struct ComponentOf;
+template<> struct ComponentOf<Orbit>  { enum { id = COMP_ORBIT }; };
+template<> struct ComponentOf<Spin>   { enum { id = COMP_SPIN }; };
+template<> struct ComponentOf<Render> { enum { id = COMP_RENDER }; };
+template<> struct ComponentOf<Ring>   { enum { id = COMP_RING }; };
+template<> struct ComponentOf<Light>  { enum { id = COMP_LIGHT }; };
+template<> struct ComponentOf<Camera> { enum { id = COMP_CAMERA }; };
+template<class T> unsigned compBit() { return 1u << ComponentOf<T>::id; }
+
+struct Archetype {
+    unsigned mask;
+    std::vector<Entity> entities;
+    std::vector<unsigned char> columns[COMPONENT_TYPES];   // vazias para componentes fora da máscara
+    template<class T> bool has() const { return (mask & compBit<T>()) != 0; }
+    template<class T> T* column() { return (T*)columns[ComponentOf<T>::id].data(); }
+    int size() const { return (int)entities.size(); }
+};
+
+struct EcsWorld {
+    std::vector<Archetype> archetypes;
+    std::vector<int> archetypeOf, rowOf;                  // por entidade
+};
+
+template<class T> bool ecsHas(EcsWorld& w, Entity e) {
+    return w.archetypes[w.archetypeOf[e]].has<T>();
+}
+
+// O ponteiro vale até a próxima ecsCreate no mesmo arquétipo
+template<class T> T* ecsGet(EcsWorld& w, Entity e) {
+    Archetype& arch = w.archetypes[w.archetypeOf[e]];
+    return arch.has<T>() ? arch.column<T>() + w.rowOf[e] : NULL;
+}
+
+// Corpos da cena no quadro atual (posições, escala e rotação própria)
+struct BodyInstance {
+    float pos[3];
+    double world[3];      // mesma posição em double (renderização relativa à câmera)
+    float rot[9];         // rotação de mundo (3x3 em colunas, do grafo de cena)
+    float radius;
+    int texture;          // índice em cpuTextures (-1 = sem textura, usa tint)
+    float tint[3];
+    bool emissive;        // tem Light (o Sol)
+    bool hasRing;
+    Ring ring;
+};
+
+// Reduz x a [0, period) (mais barato que fmod; exato o bastante em double)
+inline double wrapPeriod(double x, double period) {
+    return x - floor(x / period) * period;
+}
+
+extern double worldOrigin[3];
+
+void updateFloatingOrigin(const double eye[3]);
+
+// Grafo de cena plano (pai antes do filho, em pré-ordem) com transformações
+// de mundo em cache
+struct alignas(16) SgRot { float col[12]; };  // 3 colunas (x, y, z, 0)
+struct alignas(16) SgPos { double p[4]; };    // (x, y, z, 0)
+
+struct SceneGraph {
+    int count = 0;
+    std::vector<int> parent;                    // -1 = raiz; sempre < índice do filho
+    std::vector<int> subtreeEnd;
+    std::vector<SgRot> localRot, worldRot;
+    std::vector<SgPos> localPos, worldPos;
+    std::vector<unsigned char> localDirty, subtreeDirty, changed;
+    int updated = 0;                            // nós recalculados na última passada
+};
+
+int sgAddNode(SceneGraph& g, int parent);
+void sgFinalize(SceneGraph& g, std::vector<int>& remap);
+void sgSetLocal(SceneGraph& g, int i, const float rot[9], const double pos[3]);
+void sgUpdate(SceneGraph& g);
+void sgWorld(const SceneGraph& g, int i, double pos[3], float rot[9]);
+
+// Luas e o sistema solar montado como entidades
+const int NUM_MOONS = 6;
+const int NUM_BODIES = 9 + NUM_MOONS;   // entidades com Render: 0 = Sol, 1..8 = planetas, 9.. = luas
+
+void orbitOffset(const Orbit& o, double time, double out[3], float tangent[3]);
+float spinAngle(const Spin& sp, const Orbit* o, double steps, double time);
+
+// Sistema solar como entidades: o Sol (Render + Light + Camera), os planetas
+// (Orbit + Spin + Render + Camera, + Ring se o catálogo tiver anel) e as luas
+// (as mesmas, com Spin sincronizada). No grafo, cada Orbit tem um plano fixo
+// sob o nó da órbita do pai (raiz para o Sol) e um nó com a posição na
+// órbita; o corpo (Spin/Render) fica sob esse nó.
+struct SolarSystem {
+    EcsWorld ecs;
+    SceneGraph g;
+    int root = -1;
+    Entity sun = -1;
+    Entity slotEntity[NUM_BODIES];
+    unsigned long long step = ~0ULL;
+};
+
+SolarSystem& solarEntities();
+Entity bodyEntity(int slot);
+const Light& sunLight();
+int computeBodies(BodyInstance out[NUM_BODIES]);
+
+#endif
@@ -0,0 +1,246 @@
+#include "camera.h"
+
+#include "app.h"
+#include "bodies.h"
+
+// Câmera
+float camAngle = 0.0f;
+float camDistance = 90.0f;     // distância da câmera ao centro (zoom)
+float camHeight = 5.0f;
+float camAngleManual = 0.0f;   // offset manual via teclado (a/d)
+float orbitCameraScale = 1.0f;
+
+// ---------------------------------------------------------------------------
+// Modos de câmera. A órbita original continua sendo o padrão; os outros
+// seguem um corpo (camTarget: 0 = Sol, 1..8 = planetas, 9.. = luas). Cada modo só define
+// uma pose "alvo"; a pose usada segue o alvo por molas criticamente
+// amortecidas (sem oscilar), um passo por tick da simulação, então trocas de
+// modo/corpo viram transições suaves e o replay continua determinístico.
+const char* cameraModeNames[CAM_MODES] = {"orbita", "perseguicao", "superficie", "livre"};
+
+int camMode = CAM_ORBIT;
+int camTarget = 3;
+float chaseDistance = 6.0f;        // distância de perseguição, em raios do corpo
+double freePos[3];
+float freeYaw = 0.0f, freePitch = 0.0f;
+const float CAM_SMOOTH_TIME = 0.35f;   // segundos até a câmera "alcançar" o alvo
+const float TICK_SECONDS = 1.0f / 60.0f;
+
+CameraRig camRig;
+
+// Posição de um corpo daqui a 'ahead' ticks: soma das órbitas até a raiz
+void bodyPositionAhead(int body, int ahead, double out[3], float* radius) {
+    EcsWorld& w = solarEntities().ecs;
+    Entity e = bodyEntity(body);
+    *radius = ecsGet<Render>(w, e)->radius;
+    out[0] = out[1] = out[2] = 0.0;
+    double time = t + (paused ? 0 : ahead) * SIM_DT;
+    for (const Orbit* o = ecsGet<Orbit>(w, e); o; o = ecsGet<Orbit>(w, o->parent)) {
+        double offset[3];
+        orbitOffset(*o, time, offset, NULL);
+        for (int k = 0; k < 3; ++k) out[k] += offset[k];
+    }
+}
+
+void anchorPosition(int anchor, int ahead, double out[3]) {
+    float r;
+    if (anchor < 0) out[0] = out[1] = out[2] = 0.0;
+    else bodyPositionAhead(anchor, ahead, out, &r);
+}
+
+// Pose alvo do modo atual daqui a 'ahead' ticks (0 = agora), relativa à
+// âncora devolvida
+int cameraGoal(int ahead, double eye[3], double center[3], double up[3]) {
+    int adv = paused ? 0 : ahead;
+    up[0] = 0; up[1] = 1; up[2] = 0;
+    if (camMode == CAM_ORBIT) {                 // orbita o centro 0,0,0 e olha para o Sol
+        float angle = camAngle + 0.002f * adv + camAngleManual;
+        eye[0] = camDistance * orbitCameraScale * cos(angle);
+        eye[1] = camHeight * orbitCameraScale;
+        eye[2] = camDistance * orbitCameraScale * sin(angle);
+        center[0] = center[1] = center[2] = 0.0;
+        return -1;
+    }
+    if (camMode == CAM_FREE) {
+        float dir[3] = {cosf(freePitch) * cosf(freeYaw), sinf(freePitch), cosf(freePitch) * sinf(freeYaw)};
+        for (int k = 0; k < 3; ++k) {
+            eye[k] = freePos[k];
+            center[k] = freePos[k] + dir[k];
+        }
+        return -1;
+    }
+    EcsWorld& w = solarEntities().ecs;
+    Entity e = bodyEntity(camTarget);
+    float r = ecsGet<Render>(w, e)->radius;
+    const Orbit* orbit = ecsGet<Orbit>(w, e);
+    const Spin* spin = ecsGet<Spin>(w, e);
+    double time = t + adv * SIM_DT;
+    double rel[3] = {0, 0, 0};                               // posição relativa ao pai
+    float tangent[3] = {0, 0, 1};                            // direção do movimento orbital
+    if (orbit) orbitOffset(*orbit, time, rel, tangent);
+    if (camMode == CAM_CHASE) {
+        float d = chaseDistance * r;
+        for (int k = 0; k < 3; ++k) {
+            eye[k] = -tangent[k] * d;
+            center[k] = 0.0;
+        }
+        eye[1] += 0.35f * d;
+        return camTarget;
+    }
+    // CAM_SURFACE: ponto fixo no equador do corpo (gira com a rotação própria;
+    // com rotação sincronizada, a face oposta ao pai, que ela mantém)
+    float n[3], east[3];
+    if (spin && spin->synchronous && orbit) {
+        double len = sqrt(rel[0] * rel[0] + rel[1] * rel[1] + rel[2] * rel[2]);
+        for (int k = 0; k < 3; ++k) { n[k] = (float)(rel[k] / len); east[k] = tangent[k]; }
+    } else {
+        float deg = spin ? spinAngle(*spin, orbit, (double)simSteps, t) + spin->degPerStep * adv : 0.0f;
+        float a = deg * (float)M_PI / 180.0f;
+        n[0] = cosf(a); n[1] = 0.0f; n[2] = -sinf(a);       // normal da superfície (glRotatef em y)
+        east[0] = -n[2]; east[1] = 0.0f; east[2] = n[0];
+    }
+    float height = ecsGet<Camera>(w, e)->surfaceHeight;
+    for (int k = 0; k < 3; ++k) {
+        eye[k] = n[k] * r * height;
+        center[k] = eye[k] + (east[k] * 8.0f + n[k] * 1.2f) * r;  // horizonte, um pouco acima
+        up[k] = n[k];
+    }
+    return camTarget;
+}
+
+// Próximo corpo (na ordem dos slots) que tem o componente Camera
+int nextCameraTarget(int body, int dir) {
+    EcsWorld& w = solarEntities().ecs;
+    for (int k = 1; k <= NUM_BODIES; ++k) {
+        int slot = ((body + dir * k) % NUM_BODIES + NUM_BODIES) % NUM_BODIES;
+        if (ecsHas<Camera>(w, bodyEntity(slot))) return slot;
+    }
+    return body;
+}
+
+// Mola criticamente amortecida (forma fechada aproximada, estável para qualquer dt)
+double springStep(double current, double target, double& velocity, double smoothTime, double dt) {
+    double omega = 2.0 / smoothTime;
+    double x = omega * dt;
+    double decay = 1.0 / (1.0 + x + 0.48 * x * x + 0.235 * x * x * x);
+    double change = current - target;
+    double temp = (velocity + omega * change) * dt;
+    velocity = (velocity - omega * temp) * decay;
+    return target + (change + temp) * decay;
+}
+
+// Um passo da mola contra o alvo do tick 'ahead'. Troca de âncora (modo ou
+// corpo) reescreve a pose na nova âncora sem saltos e a mola faz a transição.
+void springCameraRig(CameraRig& rig, int ahead) {
+    double eye[3], center[3], up[3];
+    int anchor = cameraGoal(ahead, eye, center, up);
+    if (!rig.valid) {
+        for (int k = 0; k < 3; ++k) {
+            rig.eye[k] = eye[k]; rig.center[k] = center[k]; rig.up[k] = up[k];
+            rig.eyeVel[k] = rig.centerVel[k] = rig.upVel[k] = 0.0;
+        }
+        rig.anchor = anchor;
+        rig.valid = true;
+        return;
+    }
+    if (anchor != rig.anchor) {
+        double from[3], to[3];
+        anchorPosition(rig.anchor, ahead, from);
+        anchorPosition(anchor, ahead, to);
+        for (int k = 0; k < 3; ++k) {
+            rig.eye[k] += from[k] - to[k];
+            rig.center[k] += from[k] - to[k];
+        }
+        rig.anchor = anchor;
+    }
+    for (int k = 0; k < 3; ++k) {
+        rig.eye[k]    = springStep(rig.eye[k],    eye[k],    rig.eyeVel[k],    CAM_SMOOTH_TIME, TICK_SECONDS);
+        rig.center[k] = springStep(rig.center[k], center[k], rig.centerVel[k], CAM_SMOOTH_TIME, TICK_SECONDS);
+        rig.up[k]     = springStep(rig.up[k],     up[k],     rig.upVel[k],     CAM_SMOOTH_TIME, TICK_SECONDS);
+    }
+}
+
+// Pose absoluta do rig no tick 'ahead'
+void rigPose(const CameraRig& rig, int ahead, double eye[3], double center[3], double up[3]) {
+    double base[3];
+    anchorPosition(rig.anchor, ahead, base);
+    for (int k = 0; k < 3; ++k) {
+        eye[k] = base[k] + rig.eye[k];
+        center[k] = base[k] + rig.center[k];
+        up[k] = rig.up[k];
+    }
+}
+
+// Avança a pose suavizada um tick em direção ao alvo (e a origem flutuante junto)
+void stepCameraRig(CameraRig& rig) {
+    springCameraRig(rig, 0);
+    double eye[3], center[3], up[3];
+    rigPose(rig, 0, eye, center, up);
+    updateFloatingOrigin(eye);
+}
+
+// Pose prevista daqui a 'ahead' ticks: simula as molas contra os alvos futuros
+void predictCamera(int ahead, double eye[3], double center[3], double up[3]) {
+    CameraRig rig = camRig;
+    for (int i = 1; i <= ahead; ++i) springCameraRig(rig, i);
+    rigPose(rig, ahead, eye, center, up);
+}
+
+// Pose atual da câmera principal: em double (renderização relativa à câmera)
+// e em float (renderizadores em CPU)
+void cameraViewD(double eye[3], double center[3], double up[3]) {
+    if (!camRig.valid) stepCameraRig(camRig);
+    rigPose(camRig, 0, eye, center, up);
+}
+
+// Em float: relativa à origem flutuante
+void cameraView(float eye[3], float center[3], float up[3]) {
+    double e[3], c[3], u[3];
+    cameraViewD(e, c, u);
+    for (int k = 0; k < 3; ++k) {
+        eye[k] = (float)(e[k] - worldOrigin[k]);
+        center[k] = (float)(c[k] - worldOrigin[k]);
+        up[k] = (float)u[k];
+    }
+}
+
+void setCameraMode(int mode) {
+    if (mode == CAM_FREE) {                     // voo livre parte da pose atual
+        double eye[3], center[3], up[3];
+        cameraViewD(eye, center, up);
+        double d[3] = {center[0] - eye[0], center[1] - eye[1], center[2] - eye[2]};
+        double len = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        for (int k = 0; k < 3; ++k) freePos[k] = eye[k];
+        freeYaw = (float)atan2(d[2], d[0]);
+        freePitch = (float)asin(d[1] / len);
+    }
+    camMode = mode;
+}
+
+// Teclas de câmera conforme o modo (Z/z/w/s/a/d)
+void cameraKey(unsigned char key) {
+    if (camMode == CAM_ORBIT) {
+        switch (key) {
+            case 'Z': camDistance -= 5; if(camDistance < 10)  camDistance = 10;  break; // aproxima
+            case 'z': camDistance += 5; if(camDistance > 200) camDistance = 200; break; // afasta
+            case 'w': camHeight += 2;   if(camHeight > 50)    camHeight = 50;    break; // sobe
+            case 's': camHeight -= 2;   if(camHeight < 1)     camHeight = 1;     break; // desce
+            case 'a': camAngleManual -= 0.05f; break;  // gira manualmente para a esquerda
+            case 'd': camAngleManual += 0.05f; break;  // gira manualmente para a direita
+        }
+    } else if (camMode == CAM_FREE) {
+        float dir[3] = {cosf(freePitch) * cosf(freeYaw), sinf(freePitch), cosf(freePitch) * sinf(freeYaw)};
+        switch (key) {
+            case 'Z': for (int k = 0; k < 3; ++k) freePos[k] += dir[k] * 2.0f * orbitCameraScale; break;  // avança
+            case 'z': for (int k = 0; k < 3; ++k) freePos[k] -= dir[k] * 2.0f * orbitCameraScale; break;  // recua
+            case 'w': freePitch = std::min(freePitch + 0.05f,  1.5f); break;
+            case 's': freePitch = std::max(freePitch - 0.05f, -1.5f); break;
+            case 'a': freeYaw -= 0.05f; break;
+            case 'd': freeYaw += 0.05f; break;
+        }
+    } else if (key == 'Z') {
+        chaseDistance = std::max(chaseDistance / 1.25f, 2.0f);
+    } else if (key == 'z') {
+        chaseDistance = std::min(chaseDistance * 1.25f, 40.0f);
+    }
+}
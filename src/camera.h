@@ -0,0 +1,117 @@
+// Câmera (órbita, perseguição, superfície e voo livre) e matrizes 4x4 para
+// os renderizadores em CPU
+#ifndef SOLAR_CAMERA_H
+#define SOLAR_CAMERA_H
+
+#include "common.h"
+
+extern float camAngle;         // rotação automática da câmera em torno do centro
+extern float orbitCameraScale; // multiplica camDistance/camHeight na câmera em órbita
+
+enum CameraMode {
+    CAM_ORBIT = 0,      // orbita a origem (camDistance/camHeight/camAngle)
+    CAM_CHASE,          // atrás do corpo, na direção do movimento orbital
+    CAM_SURFACE,        // na superfície do corpo, girando com ele, olhando o horizonte
+    CAM_FREE,           // voo livre (posição + yaw/pitch)
+    CAM_MODES
+};
+
+extern const char* cameraModeNames[CAM_MODES];
+extern int camMode;
+extern int camTarget; // corpo seguido (Terra)
+
+struct CameraRig {
+    // Pose suavizada (a que é desenhada), em double e relativa à âncora: o
+    // corpo seguido (ou a origem, anchor = -1). Assim a mola só amortece
+    // mudanças de enquadramento, não o movimento orbital do corpo.
+    double eye[3], center[3], up[3];
+    double eyeVel[3], centerVel[3], upVel[3];
+    int anchor;
+    bool valid;                                // false = encaixa direto no alvo
+};
+
+extern CameraRig camRig;
+
+void bodyPositionAhead(int body, int ahead, double out[3], float* radius);
+int nextCameraTarget(int body, int dir);
+void stepCameraRig(CameraRig& rig);
+void predictCamera(int ahead, double eye[3], double center[3], double up[3]);
+void cameraViewD(double eye[3], double center[3], double up[3]);
+void cameraView(float eye[3], float center[3], float up[3]);
+void setCameraMode(int mode);
+void cameraKey(unsigned char key);
+
+// Matrizes 4x4 (coluna-maior, como no OpenGL) para os renderizadores em CPU
+struct Mat4 {
+    float m[16];
+};
+
+inline Mat4 mat4Identity() {
+    Mat4 r = {{1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1}};
+    return r;
+}
+
+inline Mat4 mat4Mul(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+    for (int c = 0; c < 4; ++c)
+        for (int l = 0; l < 4; ++l)
+            r.m[c*4+l] = a.m[l] * b.m[c*4] + a.m[4+l] * b.m[c*4+1] + a.m[8+l] * b.m[c*4+2] + a.m[12+l] * b.m[c*4+3];
+    return r;
+}
+
+inline Mat4 mat4Translate(float x, float y, float z) {
+    Mat4 r = mat4Identity();
+    r.m[12] = x; r.m[13] = y; r.m[14] = z;
+    return r;
+}
+
+inline Mat4 mat4Scale(float s) {
+    Mat4 r = mat4Identity();
+    r.m[0] = r.m[5] = r.m[10] = s;
+    return r;
+}
+
+// Mesma convenção do glRotatef (ângulo em graus, eixo normalizado aqui)
+inline Mat4 mat4Rotate(float deg, float x, float y, float z) {
+    float len = sqrtf(x*x + y*y + z*z);
+    x /= len; y /= len; z /= len;
+    float a = deg * (float)M_PI / 180.0f, c = cosf(a), s = sinf(a), k = 1.0f - c;
+    Mat4 r = {{x*x*k + c,   y*x*k + z*s, x*z*k - y*s, 0,
+               x*y*k - z*s, y*y*k + c,   y*z*k + x*s, 0,
+               x*z*k + y*s, y*z*k - x*s, z*z*k + c,   0,
+               0, 0, 0, 1}};
+    return r;
+}
+
+// Mesma matriz do gluPerspective
+inline Mat4 mat4Perspective(float fovyDeg, float aspect, float zNear, float zFar) {
+    float f = 1.0f / tanf(fovyDeg * (float)M_PI / 360.0f);
+    Mat4 r = {{f / aspect, 0, 0, 0,
+               0, f, 0, 0,
+               0, 0, (zFar + zNear) / (zNear - zFar), -1,
+               0, 0, 2.0f * zFar * zNear / (zNear - zFar), 0}};
+    return r;
+}
+
+// Mesma matriz do gluLookAt
+inline Mat4 mat4LookAt(const float eye[3], const float center[3], const float up[3]) {
+    float f[3] = {center[0]-eye[0], center[1]-eye[1], center[2]-eye[2]};
+    float fl = sqrtf(f[0]*f[0] + f[1]*f[1] + f[2]*f[2]);
+    for (int i = 0; i < 3; ++i) f[i] /= fl;
+    float s[3] = {f[1]*up[2] - f[2]*up[1], f[2]*up[0] - f[0]*up[2], f[0]*up[1] - f[1]*up[0]};
+    float sl = sqrtf(s[0]*s[0] + s[1]*s[1] + s[2]*s[2]);
+    for (int i = 0; i < 3; ++i) s[i] /= sl;
+    float u[3] = {s[1]*f[2] - s[2]*f[1], s[2]*f[0] - s[0]*f[2], s[0]*f[1] - s[1]*f[0]};
+    Mat4 r = {{s[0], u[0], -f[0], 0,
+               s[1], u[1], -f[1], 0,
+               s[2], u[2], -f[2], 0,
+               0, 0, 0, 1}};
+    return mat4Mul(r, mat4Translate(-eye[0], -eye[1], -eye[2]));
+}
+
+inline void mat4Apply(const Mat4& a, const float in[4], float out[4]) {
+    for (int l = 0; l < 4; ++l)
+        out[l] = a.m[l] * in[0] + a.m[4+l] * in[1] + a.m[8+l] * in[2] + a.m[12+l] * in[3];
+}
+
+#endif
@@ -0,0 +1,239 @@
+#include "comets.h"
+
+#include "app.h"
+#include "belts.h"
+#include "bodies.h"
+#include "render.h"
+#include "runtime.h"
+#include "stars.h"
+
+// ---------------------------------------------------------------------------
+// Cometas em órbitas muito excêntricas. O núcleo segue Kepler em double (como
+// os planetas, a anomalia média sai do tempo absoluto); perto do Sol cada
+// cometa emite partículas de cauda numa taxa que cresce com 1/r^2. Íons saem
+// em linha reta na direção oposta ao Sol; a poeira herda a velocidade do
+// núcleo e sente a gravidade reduzida pela pressão de radiação, o que curva a
+// cauda. As partículas vêm de um pool de capacidade fixa com free list
+// (nenhuma alocação depois da inicialização); pool cheio = a emissão espera.
+const float COMET_EMIT_RATE = 40.0f;            // partículas por passo a 1 UA do Sol
+const float COMET_MAX_EMIT = 160.0f;            // limite por passo (periélio rasante)
+
+// Distâncias em unidades da órbita da Terra (24 na escala comprimida, 1 UA na real)
+struct CometRanges {
+    float perihelion[2], aphelion[2];
+    float activeDistance;               // sem emissão além disto
+    float ionSpeed;                     // UA por unidade de tempo
+    float nucleusSize;                  // brilho do núcleo
+};
+const CometRanges cometRanges[2] = {
+    {{0.55f, 1.0f}, {4.0f, 8.0f}, 3.0f, 0.35f, 1.0f},        // comprimida (Sol com raio 0,42 "UA")
+    {{0.3f, 1.0f}, {5.0f, 35.0f}, 5.0f, 0.35f, 1.0f},        // real
+};
+
+struct Comet {
+    double P[3], Q[3];                  // a * P (periélio) e b * Q, como nos cinturões
+    double e, meanMotion, meanAnomaly0; // rad por unidade de tempo, rad
+    double pos[3], vel[3];              // heliocêntricas, no passo atual
+    float activity;                     // multiplica a taxa de emissão
+    float emitDebt;                     // fração de partícula devida do passo anterior
+    uint64_t rng;
+};
+
+struct CometParticle {
+    float pos[3], vel[3];               // heliocêntricas
+    float age, life;                    // life = 0: slot livre
+    float beta;                         // poeira: pressão de radiação / gravidade; íon: < 0
+    int next;                           // próximo slot livre
+};
+
+int cometCount = 24;
+bool showComets = true;
+Comet comets[MAX_COMETS];
+CometParticle cometPool[COMET_POOL];
+int cometFreeHead = -1, cometPoolEnd = 0;   // slots >= cometPoolEnd nunca foram usados
+int cometLive = 0;
+CometVertex cometVerts[COMET_POOL + MAX_COMETS];
+int cometVertCount = 0;
+double cometStepMs = 0.0;
+unsigned long cometSteps = 0;
+
+// Anomalia excêntrica com Newton (partida em pi para e alto; converge em poucas iterações)
+double solveKepler(double M, double e) {
+    double E = e > 0.8 ? M_PI : M;
+    for (int k = 0; k < 30; ++k) {
+        double dE = (E - e * sin(E) - M) / (1.0 - e * cos(E));
+        E -= dE;
+        if (fabs(dE) < 1e-12) break;
+    }
+    return E;
+}
+
+void cometPoolReset() {
+    cometFreeHead = -1;
+    cometPoolEnd = 0;
+    cometLive = 0;
+    for (int i = 0; i < COMET_POOL; ++i) cometPool[i].life = 0.0f;
+}
+
+int cometAllocParticle() {
+    int i;
+    if (cometFreeHead >= 0) { i = cometFreeHead; cometFreeHead = cometPool[i].next; }
+    else if (cometPoolEnd < COMET_POOL) i = cometPoolEnd++;
+    else return -1;
+    cometLive++;
+    return i;
+}
+
+void cometFreeParticle(int i) {
+    cometPool[i].life = 0.0f;
+    cometPool[i].next = cometFreeHead;                  // LIFO: os slots vivos ficam no começo do pool
+    cometFreeHead = i;
+    cometLive--;
+}
+
+// Órbitas sorteadas pela --seed (depois de --true-scale, que muda as distâncias)
+void generateComets() {
+    static bool generated = false;
+    if (generated) return;
+    generated = true;
+    cometCount = std::max(0, std::min(cometCount, MAX_COMETS));
+    const CometRanges& r = cometRanges[trueScale ? 1 : 0];
+    double au = orbitRadii[2], earthMotion = orbitSpeeds[2];
+    for (int c = 0; c < cometCount; ++c) {
+        Comet& k = comets[c];
+        uint64_t state = (uint64_t)starSeed * 0x9E3779B97F4A7C15ULL ^ ((uint64_t)(c + 1) << 40);
+        double q = au * (r.perihelion[0] + (r.perihelion[1] - r.perihelion[0]) * uniform01(state));
+        double Q = au * (r.aphelion[0] + (r.aphelion[1] - r.aphelion[0]) * uniform01(state));
+        double a = 0.5 * (q + Q);
+        k.e = (Q - q) / (Q + q);
+        double inc = M_PI * uniform01(state) * uniform01(state);   // maioria perto da eclíptica, algumas retrógradas
+        double node = 2.0 * M_PI * uniform01(state), peri = 2.0 * M_PI * uniform01(state);
+        double ci = cos(inc), si = sin(inc), cn = cos(node), sn = sin(node), cp = cos(peri), sp = sin(peri);
+        double b = a * sqrt(1.0 - k.e * k.e);
+        k.P[0] = a * (cn * cp - sn * sp * ci); k.P[2] = a * (sn * cp + cn * sp * ci); k.P[1] = a * sp * si;
+        k.Q[0] = b * (-cn * sp - sn * cp * ci); k.Q[2] = b * (-sn * sp + cn * cp * ci); k.Q[1] = b * cp * si;
+        k.meanMotion = earthMotion * pow(a / au, -1.5);
+        k.meanAnomaly0 = 2.0 * M_PI * uniform01(state);
+        k.activity = 0.5f + uniform01(state);
+        k.emitDebt = 0.0f;
+        k.rng = state;
+    }
+    cometPoolReset();
+}
+
+// Núcleo no tempo 'time': posição e velocidade (derivada de E)
+void cometState(const Comet& k, double time, double pos[3], double vel[3]) {
+    double M = wrapPeriod(k.meanAnomaly0 + k.meanMotion * time, 2.0 * M_PI);
+    double E = solveKepler(M, k.e), cE = cos(E), sE = sin(E);
+    double dE = k.meanMotion / (1.0 - k.e * cE);
+    for (int i = 0; i < 3; ++i) {
+        pos[i] = k.P[i] * (cE - k.e) + k.Q[i] * sE;
+        vel[i] = (-k.P[i] * sE + k.Q[i] * cE) * dE;
+    }
+}
+
+void cometEmit(Comet& k, double au, const CometRanges& ranges) {
+    double r = sqrt(k.pos[0] * k.pos[0] + k.pos[1] * k.pos[1] + k.pos[2] * k.pos[2]);
+    if (r > ranges.activeDistance * au) return;
+    float rAu = (float)(r / au);
+    k.emitDebt += std::min(COMET_EMIT_RATE * k.activity / (rAu * rAu), COMET_MAX_EMIT);
+    float away[3] = {(float)(k.pos[0] / r), (float)(k.pos[1] / r), (float)(k.pos[2] / r)};
+    for (; k.emitDebt >= 1.0f; k.emitDebt -= 1.0f) {
+        int i = cometAllocParticle();
+        if (i < 0) { k.emitDebt = 0.0f; return; }          // pool cheio
+        CometParticle& p = cometPool[i];
+        bool ion = uniform01(k.rng) < 0.4f;
+        float jitter[3];
+        for (int j = 0; j < 3; ++j) jitter[j] = uniform01(k.rng) - 0.5f;
+        for (int j = 0; j < 3; ++j) p.pos[j] = (float)k.pos[j];
+        if (ion) {                                         // vento solar: reto, para longe do Sol
+            float speed = ranges.ionSpeed * (float)au * (0.8f + 0.4f * uniform01(k.rng));
+            for (int j = 0; j < 3; ++j) p.vel[j] = speed * (away[j] + 0.05f * jitter[j]);
+            p.beta = -1.0f;
+            p.life = 1.5f + 1.0f * uniform01(k.rng);
+        } else {                                           // poeira: velocidade do núcleo + ejeção lenta
+            float eject = 0.02f * ranges.ionSpeed * (float)au;
+            for (int j = 0; j < 3; ++j) p.vel[j] = (float)k.vel[j] + eject * (away[j] + jitter[j]);
+            p.beta = 0.6f + 0.6f * uniform01(k.rng);
+            p.life = 4.0f + 4.0f * uniform01(k.rng);
+        }
+        p.age = 0.0f;
+    }
+}
+
+// Um passo da simulação: núcleos, emissão, integração das caudas e a lista de
+// desenho. Tudo serial e determinístico (replay).
+void stepComets() {
+    if (cometCount <= 0) return;
+    TRACE_SCOPE("cometas");
+    double t0 = nowMs();
+    generateComets();
+    const CometRanges& ranges = cometRanges[trueScale ? 1 : 0];
+    double au = orbitRadii[2];
+    float gm = (float)(orbitSpeeds[2] * orbitSpeeds[2] * au * au * au);   // 3ª lei de Kepler (órbita da Terra)
+    const float dt = (float)SIM_DT;
+
+    for (int c = 0; c < cometCount; ++c) {
+        cometState(comets[c], t, comets[c].pos, comets[c].vel);
+        cometEmit(comets[c], au, ranges);
+    }
+
+    const float ionColor[3] = {0.35f, 0.55f, 1.0f}, dustColor[3] = {1.0f, 0.85f, 0.6f};
+    int n = 0;
+    for (int i = 0; i < cometPoolEnd; ++i) {
+        CometParticle& p = cometPool[i];
+        if (p.life == 0.0f) continue;
+        p.age += dt;
+        if (p.age >= p.life) { cometFreeParticle(i); continue; }
+        if (p.beta >= 0.0f) {                              // gravidade * (1 - beta), semi-implícito
+            float r2 = p.pos[0] * p.pos[0] + p.pos[1] * p.pos[1] + p.pos[2] * p.pos[2];
+            float s = gm * (p.beta - 1.0f) / (r2 * sqrtf(r2)) * dt;
+            for (int j = 0; j < 3; ++j) p.vel[j] += s * p.pos[j];
+        }
+        for (int j = 0; j < 3; ++j) p.pos[j] += p.vel[j] * dt;
+        float fade = 1.0f - p.age / p.life;
+        const float* tint = p.beta < 0.0f ? ionColor : dustColor;
+        CometVertex& v = cometVerts[n++];
+        for (int j = 0; j < 3; ++j) {
+            v.pos[j] = p.pos[j];
+            v.color[j] = tint[j] * fade * 0.5f;
+        }
+    }
+    for (int c = 0; c < cometCount; ++c) {                 // núcleos (coma) por último
+        const Comet& k = comets[c];
+        double r = sqrt(k.pos[0] * k.pos[0] + k.pos[1] * k.pos[1] + k.pos[2] * k.pos[2]) / au;
+        float glow = std::min(1.0f, 0.15f + ranges.nucleusSize / (float)(r * r));
+        CometVertex& v = cometVerts[n++];
+        for (int j = 0; j < 3; ++j) {
+            v.pos[j] = (float)k.pos[j];
+            v.color[j] = glow * (j == 2 ? 1.0f : 0.9f);
+        }
+    }
+    cometVertCount = n;
+    cometStepMs += nowMs() - t0;
+    cometSteps++;
+}
+
+// Caudas e núcleos dos cometas (lista montada em stepComets; soma de luz)
+void drawComets(const float offset[3]) {
+    if (!showComets || cometVertCount == 0) return;
+    TRACE_SCOPE("cometas");
+    glPushMatrix();
+    glTranslatef(offset[0], offset[1], offset[2]);      // posições relativas ao Sol
+    setLighting(false);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glPointSize(2.0f * renderScale);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(CometVertex), cometVerts[0].pos);
+    glColorPointer(3, GL_FLOAT, sizeof(CometVertex), cometVerts[0].color);
+    glDrawArrays(GL_POINTS, 0, cometVertCount);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+    setLighting(true);
+    glPopMatrix();
+}
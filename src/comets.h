@@ -0,0 +1,26 @@
+// Cometas em órbitas excêntricas com caudas de partículas num pool fixo
+#ifndef SOLAR_COMETS_H
+#define SOLAR_COMETS_H
+
+#include "common.h"
+
+const int MAX_COMETS = 64;
+const int COMET_POOL = 1 << 16;                 // partículas de cauda (todas os cometas)
+
+struct CometVertex {                    // lista de desenho (GL e software)
+    float pos[3];                       // relativa ao Sol
+    float color[3];
+};
+
+extern int cometCount;     // --comets=N (0 desliga)
+extern bool showComets;    // tecla 'C'
+extern int cometLive;
+extern CometVertex cometVerts[COMET_POOL + MAX_COMETS];
+extern int cometVertCount;
+extern double cometStepMs; // custo de CPU acumulado (--bench)
+extern unsigned long cometSteps;
+
+void stepComets();
+void drawComets(const float offset[3]);
+
+#endif
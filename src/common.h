@@ -0,0 +1,20 @@
+// Base comum a todos os módulos: OpenGL/GLUT (com as funções de extensão),
+// biblioteca C e contêineres usados em toda parte
+#ifndef SOLAR_COMMON_H
+#define SOLAR_COMMON_H
+
+#define GL_GLEXT_PROTOTYPES      // funções de extensão (PBO, buffer storage) exportadas pela libGL
+#include <GL/glut.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#endif
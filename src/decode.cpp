@@ -0,0 +1,166 @@
+#include "decode.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef SOLAR_HAVE_JPEG
+#include <setjmp.h>
+#include <jpeglib.h>
+#ifndef JCS_EXTENSIONS              // libjpeg sem as extensões do turbo (saída RGBA): só stb
+#undef SOLAR_HAVE_JPEG
+#endif
+#endif
+
+#include "stb_image.h"
+
+unsigned char* vectorSink(void* ctx, int w, int h) {
+    VectorSink* s = (VectorSink*)ctx;
+    s->rgba->resize((size_t)w * h * 4);
+    s->w = w;
+    s->h = h;
+    return s->rgba->data();
+}
+
+// ---------------------------------------------------------------------------
+// libjpeg-turbo: cada linha é escrita direto na posição final no destino (de
+// baixo para cima, sem cópia nem inversão depois) e a redução 1/N sai da IDCT
+
+#ifdef SOLAR_HAVE_JPEG
+struct JpegError {
+    jpeg_error_mgr mgr;
+    jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+    longjmp(((JpegError*)cinfo->err)->jump, 1);
+}
+
+void jpegSilent(j_common_ptr) {}       // avisos de JPEG corrompido: o stb tenta de novo
+
+bool jpegAccepts(const unsigned char* data, size_t size) {
+    return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+bool jpegDecode(const unsigned char* data, size_t size, int scale, DecodeSink sink, void* ctx) {
+    jpeg_decompress_struct cinfo;
+    JpegError err;
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpegErrorExit;
+    err.mgr.output_message = jpegSilent;
+    if (setjmp(err.jump)) {                   // CMYK, arquivo truncado...
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, data, (unsigned long)size);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_EXT_RGBA;
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = scale;
+    jpeg_start_decompress(&cinfo);
+
+    unsigned char* dst = sink(ctx, cinfo.output_width, cinfo.output_height);
+    if (!dst) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    size_t stride = (size_t)cinfo.output_width * 4;
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = dst + (cinfo.output_height - 1 - cinfo.output_scanline) * stride;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+const ImageDecoder jpegDecoder = {"libjpeg-turbo", jpegAccepts, jpegDecode};
+#endif
+
+// ---------------------------------------------------------------------------
+// stb_image: qualquer formato que ele conheça. Decodifica sempre em tamanho
+// cheio; a redução 1/N é uma média de blocos NxN depois.
+
+bool stbAccepts(const unsigned char*, size_t) {
+    return true;
+}
+
+bool stbDecode(const unsigned char* data, size_t size, int scale, DecodeSink sink, void* ctx) {
+    int w, h, n;
+    stbi_set_flip_vertically_on_load_thread(1);          // linha 0 embaixo
+    unsigned char* img = stbi_load_from_memory(data, (int)size, &w, &h, &n, 4);
+    if (!img) return false;
+    int ow = (w + scale - 1) / scale, oh = (h + scale - 1) / scale;   // mesmo arredondamento da libjpeg
+    unsigned char* dst = sink(ctx, ow, oh);
+    if (dst && scale == 1) {
+        memcpy(dst, img, (size_t)w * h * 4);
+    } else if (dst) {
+        for (int oy = 0; oy < oh; ++oy) {
+            int y0 = oy * scale, y1 = std::min(h, y0 + scale);
+            for (int ox = 0; ox < ow; ++ox) {
+                int x0 = ox * scale, x1 = std::min(w, x0 + scale);
+                unsigned sum[4] = {0, 0, 0, 0};
+                for (int y = y0; y < y1; ++y)
+                    for (int x = x0; x < x1; ++x)
+                        for (int c = 0; c < 4; ++c) sum[c] += img[((size_t)y * w + x) * 4 + c];
+                unsigned count = (unsigned)((y1 - y0) * (x1 - x0));
+                for (int c = 0; c < 4; ++c)
+                    dst[((size_t)oy * ow + ox) * 4 + c] = (unsigned char)((sum[c] + count / 2) / count);
+            }
+        }
+    }
+    stbi_image_free(img);
+    return dst != NULL;
+}
+
+const ImageDecoder stbDecoder = {"stb_image", stbAccepts, stbDecode};
+
+const ImageDecoder* imageDecoders[] = {
+#ifdef SOLAR_HAVE_JPEG
+    &jpegDecoder,
+#endif
+    &stbDecoder,
+    NULL
+};
+const ImageDecoder* forcedDecoder = NULL;
+
+const ImageDecoder* findImageDecoder(const char* name) {
+    for (const ImageDecoder** d = imageDecoders; *d; ++d)
+        if (strcmp((*d)->name, name) == 0) return *d;
+    return NULL;
+}
+
+// Primeiro backend que aceita os bytes (o do --decoder na frente); se ele
+// falhar, os seguintes tentam
+bool decodeImageMemory(const unsigned char* data, size_t size, int scale, DecodeSink sink, void* ctx) {
+    if (forcedDecoder && forcedDecoder->accepts(data, size) &&
+        forcedDecoder->decode(data, size, scale, sink, ctx)) return true;
+    for (const ImageDecoder** d = imageDecoders; *d; ++d)
+        if (*d != forcedDecoder && (*d)->accepts(data, size) && (*d)->decode(data, size, scale, sink, ctx))
+            return true;
+    return false;
+}
+
+// O arquivo é mapeado em memória: os backends leem direto do page cache
+bool decodeImageFile(const char* path, int scale, DecodeSink sink, void* ctx) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    bool ok = decodeImageMemory((const unsigned char*)map, st.st_size, scale, sink, ctx);
+    munmap(map, st.st_size);
+    return ok;
+}
+
+bool decodeImageFile(const char* path, int scale, std::vector<unsigned char>& rgba, int* w, int* h) {
+    VectorSink s = {&rgba, 0, 0};
+    if (!decodeImageFile(path, scale, vectorSink, &s)) return false;
+    *w = s.w;
+    *h = s.h;
+    return true;
+}
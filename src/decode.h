@@ -0,0 +1,38 @@
+// Decodificação de imagens com backends trocáveis: libjpeg-turbo para JPEG
+// (SIMD, e reduz 1/2, 1/4 ou 1/8 na própria IDCT) e stb_image como reserva
+// portátil para o resto ou quando o programa é compilado sem libjpeg
+#ifndef SOLAR_DECODE_H
+#define SOLAR_DECODE_H
+
+#include "common.h"
+
+// Destino dos pixels: recebe as dimensões finais e devolve w*h*4 bytes
+// (NULL recusa a imagem). Pode ser chamado de novo se um backend desistir
+// no meio e o próximo tentar.
+typedef unsigned char* (*DecodeSink)(void* ctx, int w, int h);
+
+// Destino comum: um vector redimensionado a cada imagem
+struct VectorSink {
+    std::vector<unsigned char>* rgba;
+    int w, h;
+};
+
+unsigned char* vectorSink(void* ctx, int w, int h);
+
+struct ImageDecoder {
+    const char* name;
+    bool (*accepts)(const unsigned char* data, size_t size);     // pelos bytes mágicos
+    // RGBA com a linha 0 embaixo (como o glTexImage2D espera); scale = 1, 2, 4 ou 8
+    bool (*decode)(const unsigned char* data, size_t size, int scale, DecodeSink sink, void* ctx);
+};
+
+extern const ImageDecoder* imageDecoders[];  // ordem de preferência, terminada em NULL
+extern const ImageDecoder* forcedDecoder;    // --decoder=nome: tentado primeiro (NULL = ordem da lista)
+
+const ImageDecoder* findImageDecoder(const char* name);
+
+bool decodeImageMemory(const unsigned char* data, size_t size, int scale, DecodeSink sink, void* ctx);
+bool decodeImageFile(const char* path, int scale, DecodeSink sink, void* ctx);
+bool decodeImageFile(const char* path, int scale, std::vector<unsigned char>& rgba, int* w, int* h);
+
+#endif
@@ -0,0 +1,221 @@
+#include "hdr.h"
+
+#include "render.h"
+#include "runtime.h"
+
+// ---------------------------------------------------------------------------
+// HDR e bloom. A cena vai para um alvo RGBA16F sem limitar as cores (o Sol
+// emite 1,5 e a luz difusa chega a 2,5, que no framebuffer de 8 bits viravam
+// branco chapado). O bloom é uma pirâmide de meias resoluções: a descida
+// filtra com 13 amostras (a primeira só deixa passar o que excede
+// BLOOM_THRESHOLD) e a subida soma cada nível ao de cima com uma tenda 3x3.
+// A pirâmide começa em meia resolução, então o custo é fixo (~1/3 dos pixels
+// da janela somando todos os níveis), sem blur em resolução cheia. O
+// tonemapping (ACES, com exposição) grava o resultado na janela.
+const float BLOOM_THRESHOLD = 1.0f;    // brilho a partir do qual a luz vaza
+
+HdrTarget hdrTarget;
+bool useHdr = true;
+bool showHdr = true;
+float exposure = 1.0f;
+
+// Quadrado na tela inteira (glRectf de -1 a 1, sem matrizes)
+const char* postVertexShader =
+    "#version 120\n"
+    "varying vec2 uv;\n"
+    "void main() {\n"
+    "    uv = gl_Vertex.xy * 0.5 + 0.5;\n"
+    "    gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);\n"
+    "}\n";
+
+const char* bloomDownShader =
+    "#version 120\n"
+    "uniform sampler2D source;\n"
+    "uniform vec2 texel;\n"                 // tamanho do texel do nível de origem
+    "uniform float threshold;\n"            // > 0 só na primeira descida
+    "varying vec2 uv;\n"
+    "vec3 tap(float x, float y) { return texture2D(source, uv + texel * vec2(x, y)).rgb; }\n"
+    "void main() {\n"
+    "    vec3 s = tap(0.0, 0.0) * 0.125\n"
+    "           + (tap(-1.0, 1.0) + tap(1.0, 1.0) + tap(-1.0, -1.0) + tap(1.0, -1.0)) * 0.125\n"
+    "           + (tap(0.0, 2.0) + tap(-2.0, 0.0) + tap(2.0, 0.0) + tap(0.0, -2.0)) * 0.0625\n"
+    "           + (tap(-2.0, 2.0) + tap(2.0, 2.0) + tap(-2.0, -2.0) + tap(2.0, -2.0)) * 0.03125;\n"
+    "    if (threshold > 0.0) {\n"          // joelho suave em volta do limiar
+    "        float b = max(s.r, max(s.g, s.b));\n"
+    "        float knee = 0.5 * threshold;\n"
+    "        float soft = clamp(b - threshold + knee, 0.0, 2.0 * knee);\n"
+    "        soft = soft * soft / (4.0 * knee);\n"
+    "        s *= max(soft, b - threshold) / max(b, 1e-4);\n"
+    "    }\n"
+    "    gl_FragColor = vec4(s, 1.0);\n"
+    "}\n";
+
+const char* bloomUpShader =
+    "#version 120\n"
+    "uniform sampler2D source;\n"
+    "uniform vec2 texel;\n"
+    "varying vec2 uv;\n"
+    "vec3 tap(float x, float y) { return texture2D(source, uv + texel * vec2(x, y)).rgb; }\n"
+    "void main() {\n"
+    "    vec3 s = tap(0.0, 0.0) * 4.0\n"
+    "           + (tap(0.0, 1.0) + tap(-1.0, 0.0) + tap(1.0, 0.0) + tap(0.0, -1.0)) * 2.0\n"
+    "           + tap(-1.0, 1.0) + tap(1.0, 1.0) + tap(-1.0, -1.0) + tap(1.0, -1.0);\n"
+    "    gl_FragColor = vec4(s / 16.0, 1.0);\n"
+    "}\n";
+
+const char* tonemapShader =
+    "#version 120\n"
+    "uniform sampler2D scene, bloom;\n"
+    "uniform vec2 sceneTexel;\n"            // a cena é lida por gl_FragCoord (ladrilhos do pôster)
+    "uniform float exposure, bloomStrength;\n"
+    "varying vec2 uv;\n"
+    "void main() {\n"
+    "    vec3 c = texture2D(scene, gl_FragCoord.xy * sceneTexel).rgb;\n"
+    "    if (bloomStrength > 0.0) c += bloomStrength * texture2D(bloom, uv).rgb;\n"
+    "    c *= exposure;\n"
+    "    float m = max(max(c.r, c.g), max(c.b, 1e-4));\n"   // curva no maior canal: mantém o matiz das texturas
+    "    float t = m * (2.51 * m + 0.03) / (m * (2.43 * m + 0.59) + 0.14);\n"   // ACES (aproximação de Narkowicz)
+    "    gl_FragColor = vec4(clamp(c * (t / m), 0.0, 1.0), 1.0);\n"
+    "}\n";
+
+bool hdrActive() {
+    return hdrTarget.ready && showHdr;
+}
+
+bool initHdr() {
+    if (!useHdr) return false;
+    HdrTarget& ht = hdrTarget;
+    if (glVersion() < 30 || !initSceneProgram()
+        || !(ht.downProgram = linkProgram(postVertexShader, bloomDownShader))
+        || !(ht.upProgram = linkProgram(postVertexShader, bloomUpShader))
+        || !(ht.tonemapProgram = linkProgram(postVertexShader, tonemapShader))) {
+        printf("Sem GLSL 1.20 / texturas em float: HDR desligado\n");
+        return false;
+    }
+    ht.downTexelLoc = glGetUniformLocation(ht.downProgram, "texel");
+    ht.downThresholdLoc = glGetUniformLocation(ht.downProgram, "threshold");
+    ht.upTexelLoc = glGetUniformLocation(ht.upProgram, "texel");
+    ht.sceneTexelLoc = glGetUniformLocation(ht.tonemapProgram, "sceneTexel");
+    ht.exposureLoc = glGetUniformLocation(ht.tonemapProgram, "exposure");
+    ht.bloomStrengthLoc = glGetUniformLocation(ht.tonemapProgram, "bloomStrength");
+    glUseProgram(ht.tonemapProgram);
+    glUniform1i(glGetUniformLocation(ht.tonemapProgram, "scene"), 0);
+    glUniform1i(glGetUniformLocation(ht.tonemapProgram, "bloom"), 1);
+    glUseProgram(0);
+
+    glGenFramebuffers(1, &ht.fbo);
+    glGenTextures(1, &ht.color);
+    glGenRenderbuffers(1, &ht.depth);
+    for (int i = 0; i < BLOOM_LEVELS; ++i) {
+        glGenTextures(1, &ht.bloom[i].tex);
+        glGenFramebuffers(1, &ht.bloom[i].fbo);
+    }
+    ht.ready = true;
+    printf("HDR: RGBA16F, bloom em ate %d niveis, exposicao %.2f\n", BLOOM_LEVELS, exposure);
+    return true;
+}
+
+void allocHdrTexture(GLuint tex, int width, int height) {
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+}
+
+// Alvo da cena (e pirâmide do bloom) no tamanho dado; fica ligado para desenhar
+void bindHdrTarget(int width, int height) {
+    HdrTarget& ht = hdrTarget;
+    if (ht.width != width || ht.height != height) {
+        allocHdrTexture(ht.color, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, ht.depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+        glBindFramebuffer(GL_FRAMEBUFFER, ht.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ht.color, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, ht.depth);
+        ht.levels = 0;
+        for (int w = width / 2, h = height / 2; ht.levels < BLOOM_LEVELS && w >= 4 && h >= 4; w /= 2, h /= 2) {
+            BloomLevel& l = ht.bloom[ht.levels++];
+            l.width = w;
+            l.height = h;
+            allocHdrTexture(l.tex, w, h);
+            glBindFramebuffer(GL_FRAMEBUFFER, l.fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, l.tex, 0);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        ht.width = width;
+        ht.height = height;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, ht.fbo);
+}
+
+// Pirâmide do bloom a partir da cena (alvo do tamanho da janela)
+void renderBloom() {
+    TRACE_SCOPE("bloom");
+    HdrTarget& ht = hdrTarget;
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_VIEWPORT_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+
+    gpuTimerBegin(GPU_PASS_BLOOM_DOWN);
+    glUseProgram(ht.downProgram);
+    GLuint source = ht.color;
+    int sourceW = ht.width, sourceH = ht.height;
+    for (int i = 0; i < ht.levels; ++i) {
+        const BloomLevel& l = ht.bloom[i];
+        glBindFramebuffer(GL_FRAMEBUFFER, l.fbo);
+        glViewport(0, 0, l.width, l.height);
+        glUniform2f(ht.downTexelLoc, 1.0f / sourceW, 1.0f / sourceH);
+        glUniform1f(ht.downThresholdLoc, i == 0 ? BLOOM_THRESHOLD : 0.0f);
+        glBindTexture(GL_TEXTURE_2D, source);
+        glRectf(-1, -1, 1, 1);
+        source = l.tex;
+        sourceW = l.width;
+        sourceH = l.height;
+    }
+    gpuTimerEnd();
+
+    gpuTimerBegin(GPU_PASS_BLOOM_UP);
+    glUseProgram(ht.upProgram);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);                        // soma ao que a descida deixou no nível
+    for (int i = ht.levels - 2; i >= 0; --i) {
+        const BloomLevel& l = ht.bloom[i], &below = ht.bloom[i + 1];
+        glBindFramebuffer(GL_FRAMEBUFFER, l.fbo);
+        glViewport(0, 0, l.width, l.height);
+        glUniform2f(ht.upTexelLoc, 1.0f / below.width, 1.0f / below.height);
+        glBindTexture(GL_TEXTURE_2D, below.tex);
+        glRectf(-1, -1, 1, 1);
+    }
+    gpuTimerEnd();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glPopAttrib();
+}
+
+// Exposição + tonemapping da cena (e do bloom, se bloomStrength > 0) para o
+// FBO dado, em (0, 0, width, height)
+void tonemapTo(GLuint fbo, int width, int height, float bloomStrength) {
+    HdrTarget& ht = hdrTarget;
+    glPushAttrib(GL_ENABLE_BIT | GL_VIEWPORT_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+    glUseProgram(ht.tonemapProgram);
+    glUniform2f(ht.sceneTexelLoc, 1.0f / ht.width, 1.0f / ht.height);
+    glUniform1f(ht.exposureLoc, exposure);
+    glUniform1f(ht.bloomStrengthLoc, ht.levels ? bloomStrength : 0.0f);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, ht.levels ? ht.bloom[0].tex : 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, ht.color);
+    glRectf(-1, -1, 1, 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(sceneProgramActive ? sceneProgram : 0);
+    glPopAttrib();
+}
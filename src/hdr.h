@@ -0,0 +1,36 @@
+// Alvo HDR (RGBA16F), bloom em pirâmide e tonemapping
+#ifndef SOLAR_HDR_H
+#define SOLAR_HDR_H
+
+#include "common.h"
+
+const int   BLOOM_LEVELS    = 6;
+const float BLOOM_STRENGTH  = 0.15f;   // peso do bloom somado à cena
+
+struct BloomLevel {
+    GLuint tex, fbo;
+    int width, height;
+};
+
+struct HdrTarget {
+    bool ready = false;
+    GLuint fbo = 0, color = 0, depth = 0;       // cena em RGBA16F + depth em float
+    int width = 0, height = 0;
+    BloomLevel bloom[BLOOM_LEVELS];
+    int levels = 0;                             // níveis usados no tamanho atual
+    GLuint downProgram = 0, upProgram = 0, tonemapProgram = 0;
+    GLint downTexelLoc, downThresholdLoc, upTexelLoc, sceneTexelLoc, exposureLoc, bloomStrengthLoc;
+};
+
+extern HdrTarget hdrTarget;
+extern bool useHdr;    // --no-hdr
+extern bool showHdr;   // tecla 'H'
+extern float exposure; // --exposure=X, teclas 'e' / 'E'
+
+bool hdrActive();
+bool initHdr();
+void bindHdrTarget(int width, int height);
+void renderBloom();
+void tonemapTo(GLuint fbo, int width, int height, float bloomStrength);
+
+#endif
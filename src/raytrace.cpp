@@ -0,0 +1,445 @@
+#include "raytrace.h"
+
+#include <time.h>
+#include <emmintrin.h>
+#include <atomic>
+
+#include "app.h"
+#include "bodies.h"
+#include "camera.h"
+#include "render.h"
+#include "runtime.h"
+#include "software.h"
+#include "stars.h"
+#include "texture.h"
+
+// ---------------------------------------------------------------------------
+// Ray tracer em CPU (modo "qualidade de referência" para imagens paradas):
+// todos os corpos são esferas analíticas, então sombras entre corpos
+// (eclipses), a sombra do anel de Saturno e o anti-aliasing saem exatos.
+// BVH sobre os corpos, pacotes de 4 raios (SSE) e ladrilhos no pool de threads.
+enum RtPrimType { RT_SPHERE, RT_RING };
+
+struct RtPrim {
+    int type;
+    int body;                 // índice em RtScene::bodies
+    float center[3];
+    float radius;             // esfera: raio; anel: raio externo
+    float inner;              // anel: raio interno
+    float normal[3];          // anel: normal do plano
+    float bmin[3], bmax[3];
+};
+
+struct RtNode {
+    float bmin[3], bmax[3];
+    int first, count;         // folha: primitivos [first, first+count)
+    int left;                 // nó interno: filhos left e left+1
+};
+
+const int RT_MAX_PRIMS = 2 * NUM_BODIES;         // esfera + anel por corpo
+const int RT_MAX_NODES = 2 * RT_MAX_PRIMS - 1;   // BVH binária com folhas de 1 ou 2
+
+struct RtScene {
+    BodyInstance bodies[NUM_BODIES];
+    int numBodies;
+    RtPrim prims[RT_MAX_PRIMS];
+    int numPrims;
+    int order[RT_MAX_PRIMS];  // primitivos na ordem das folhas
+    RtNode nodes[RT_MAX_NODES];
+    int numNodes;
+    float eye[3], center[3], worldUp[3];
+    float forward[3], right[3], up[3];
+    float tanHalfFov, aspect;
+    int width, height, spp;
+    uint32_t* pixels;
+    std::atomic<long long> rays{0};
+};
+
+const int   RT_TILE = 32;
+const float RT_EPS  = 1e-3f;
+
+void rtBuildNode(RtScene& sc, int index, int first, int count) {
+    RtNode& node = sc.nodes[index];
+    for (int a = 0; a < 3; ++a) { node.bmin[a] = 1e30f; node.bmax[a] = -1e30f; }
+    for (int i = first; i < first + count; ++i)
+        for (int a = 0; a < 3; ++a) {
+            node.bmin[a] = std::min(node.bmin[a], sc.prims[sc.order[i]].bmin[a]);
+            node.bmax[a] = std::max(node.bmax[a], sc.prims[sc.order[i]].bmax[a]);
+        }
+    if (count <= 2) {
+        node.first = first;
+        node.count = count;
+        return;
+    }
+    // divide na mediana dos centróides, no eixo de maior extensão
+    int axis = 0;
+    float ext[3] = {node.bmax[0] - node.bmin[0], node.bmax[1] - node.bmin[1], node.bmax[2] - node.bmin[2]};
+    if (ext[1] > ext[axis]) axis = 1;
+    if (ext[2] > ext[axis]) axis = 2;
+    std::sort(sc.order + first, sc.order + first + count, [&](int a, int b) {
+        return sc.prims[a].center[axis] < sc.prims[b].center[axis];
+    });
+    node.count = 0;
+    node.left = sc.numNodes;                   // filhos lado a lado
+    sc.numNodes += 2;
+    int half = count / 2;
+    rtBuildNode(sc, node.left, first, half);
+    rtBuildNode(sc, node.left + 1, first + half, count - half);
+}
+
+void rtBuildScene(RtScene& sc, int width, int height, int spp) {
+    sc.numBodies = computeBodies(sc.bodies);
+    sc.numPrims = 0;
+    for (int i = 0; i < sc.numBodies; ++i) {
+        const BodyInstance& b = sc.bodies[i];
+        RtPrim p;
+        p.type = RT_SPHERE;
+        p.body = i;
+        p.radius = b.radius;
+        p.inner = 0;
+        for (int a = 0; a < 3; ++a) {
+            p.center[a] = b.pos[a];
+            p.normal[a] = 0;
+            p.bmin[a] = b.pos[a] - b.radius;
+            p.bmax[a] = b.pos[a] + b.radius;
+        }
+        sc.prims[sc.numPrims++] = p;
+        if (b.hasRing) {                       // mesmo anel de drawRing (inclinado em x)
+            RtPrim r = p;
+            r.type = RT_RING;
+            r.inner = b.radius * b.ring.inner;
+            r.radius = b.radius * b.ring.outer;
+            float tilt = b.ring.tiltDeg * (float)M_PI / 180.0f;
+            r.normal[0] = 0; r.normal[1] = cosf(tilt); r.normal[2] = sinf(tilt);
+            for (int a = 0; a < 3; ++a) { r.bmin[a] = b.pos[a] - r.radius; r.bmax[a] = b.pos[a] + r.radius; }
+            sc.prims[sc.numPrims++] = r;
+        }
+    }
+    for (int i = 0; i < sc.numPrims; ++i) sc.order[i] = i;
+    sc.numNodes = 1;
+    rtBuildNode(sc, 0, 0, sc.numPrims);
+
+    float worldUp[3];
+    cameraView(sc.eye, sc.center, worldUp);
+    for (int a = 0; a < 3; ++a) sc.worldUp[a] = worldUp[a];
+    for (int a = 0; a < 3; ++a) sc.forward[a] = sc.center[a] - sc.eye[a];
+    float len = sqrtf(sc.forward[0]*sc.forward[0] + sc.forward[1]*sc.forward[1] + sc.forward[2]*sc.forward[2]);
+    for (int a = 0; a < 3; ++a) sc.forward[a] /= len;
+    sc.right[0] = sc.forward[1]*worldUp[2] - sc.forward[2]*worldUp[1];
+    sc.right[1] = sc.forward[2]*worldUp[0] - sc.forward[0]*worldUp[2];
+    sc.right[2] = sc.forward[0]*worldUp[1] - sc.forward[1]*worldUp[0];
+    len = sqrtf(sc.right[0]*sc.right[0] + sc.right[1]*sc.right[1] + sc.right[2]*sc.right[2]);
+    for (int a = 0; a < 3; ++a) sc.right[a] /= len;
+    sc.up[0] = sc.right[1]*sc.forward[2] - sc.right[2]*sc.forward[1];
+    sc.up[1] = sc.right[2]*sc.forward[0] - sc.right[0]*sc.forward[2];
+    sc.up[2] = sc.right[0]*sc.forward[1] - sc.right[1]*sc.forward[0];
+    sc.tanHalfFov = tanf(30.0f * (float)M_PI / 180.0f);      // gluPerspective(60, ...)
+    sc.aspect = (float)width / height;
+    sc.width = width;
+    sc.height = height;
+    sc.spp = spp;
+    sc.rays = 0;
+}
+
+// Pacote de 4 raios em SoA
+struct RayPacket {
+    __m128 ox, oy, oz, dx, dy, dz;
+    __m128 tmax;
+    int prim[4];              // primitivo atingido por raio (-1 = nenhum)
+};
+
+inline __m128 rtDot(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+// Interseção de 4 raios com um primitivo; atualiza tmax/prim dos raios ativos
+inline int rtIntersectPrim(const RtPrim& p, int primIndex, RayPacket& rp, __m128 active) {
+    __m128 ocx = _mm_sub_ps(rp.ox, _mm_set1_ps(p.center[0]));
+    __m128 ocy = _mm_sub_ps(rp.oy, _mm_set1_ps(p.center[1]));
+    __m128 ocz = _mm_sub_ps(rp.oz, _mm_set1_ps(p.center[2]));
+    __m128 eps = _mm_set1_ps(RT_EPS);
+    __m128 t, hit;
+    if (p.type == RT_SPHERE) {
+        __m128 b = rtDot(ocx, ocy, ocz, rp.dx, rp.dy, rp.dz);
+        __m128 c = _mm_sub_ps(rtDot(ocx, ocy, ocz, ocx, ocy, ocz), _mm_set1_ps(p.radius * p.radius));
+        __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), c);
+        __m128 sq = _mm_sqrt_ps(_mm_max_ps(disc, _mm_setzero_ps()));
+        __m128 t0 = _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), b), sq);
+        __m128 t1 = _mm_add_ps(_mm_sub_ps(_mm_setzero_ps(), b), sq);
+        __m128 useT1 = _mm_cmplt_ps(t0, eps);                        // origem dentro da esfera
+        t = _mm_or_ps(_mm_and_ps(useT1, t1), _mm_andnot_ps(useT1, t0));
+        hit = _mm_cmpge_ps(disc, _mm_setzero_ps());
+    } else {
+        __m128 nx = _mm_set1_ps(p.normal[0]), ny = _mm_set1_ps(p.normal[1]), nz = _mm_set1_ps(p.normal[2]);
+        __m128 denom = rtDot(rp.dx, rp.dy, rp.dz, nx, ny, nz);
+        t = _mm_div_ps(_mm_sub_ps(_mm_setzero_ps(), rtDot(ocx, ocy, ocz, nx, ny, nz)), denom);
+        __m128 px = _mm_add_ps(ocx, _mm_mul_ps(rp.dx, t));
+        __m128 py = _mm_add_ps(ocy, _mm_mul_ps(rp.dy, t));
+        __m128 pz = _mm_add_ps(ocz, _mm_mul_ps(rp.dz, t));
+        __m128 r2 = rtDot(px, py, pz, px, py, pz);
+        hit = _mm_and_ps(_mm_cmpge_ps(r2, _mm_set1_ps(p.inner * p.inner)),
+                         _mm_cmple_ps(r2, _mm_set1_ps(p.radius * p.radius)));
+        hit = _mm_and_ps(hit, _mm_cmpneq_ps(denom, _mm_setzero_ps()));
+    }
+    hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpgt_ps(t, eps), _mm_cmplt_ps(t, rp.tmax)));
+    hit = _mm_and_ps(hit, active);
+    int mask = _mm_movemask_ps(hit);
+    if (mask) {
+        rp.tmax = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, rp.tmax));
+        for (int lane = 0; lane < 4; ++lane)
+            if (mask & (1 << lane)) rp.prim[lane] = primIndex;
+    }
+    return mask;
+}
+
+// Percorre a BVH com o pacote. anyHit = raios de sombra (para no primeiro
+// oclusor); skipBody ignora um corpo (o Sol, que é a própria fonte de luz).
+void rtTrace(const RtScene& sc, RayPacket& rp, int activeMask, bool anyHit, int skipBody) {
+    __m128 idx = _mm_div_ps(_mm_set1_ps(1.0f), rp.dx);
+    __m128 idy = _mm_div_ps(_mm_set1_ps(1.0f), rp.dy);
+    __m128 idz = _mm_div_ps(_mm_set1_ps(1.0f), rp.dz);
+    const __m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+    __m128 active = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(laneBits, _mm_set1_epi32(activeMask)), laneBits));
+    for (int lane = 0; lane < 4; ++lane) rp.prim[lane] = -1;
+
+    int stack[32], sp = 0;
+    stack[sp++] = 0;
+    while (sp > 0) {
+        const RtNode& node = sc.nodes[stack[--sp]];
+        // teste de slab dos 4 raios contra a AABB do nó
+        __m128 tx0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmin[0]), rp.ox), idx);
+        __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmax[0]), rp.ox), idx);
+        __m128 ty0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmin[1]), rp.oy), idy);
+        __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmax[1]), rp.oy), idy);
+        __m128 tz0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmin[2]), rp.oz), idz);
+        __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmax[2]), rp.oz), idz);
+        __m128 tnear = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)), _mm_min_ps(tz0, tz1));
+        __m128 tfar  = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_max_ps(ty0, ty1)), _mm_max_ps(tz0, tz1));
+        __m128 boxHit = _mm_and_ps(_mm_cmple_ps(tnear, tfar), _mm_cmpge_ps(tfar, _mm_setzero_ps()));
+        boxHit = _mm_and_ps(_mm_and_ps(boxHit, _mm_cmple_ps(tnear, rp.tmax)), active);
+        if (!_mm_movemask_ps(boxHit)) continue;
+
+        if (node.count == 0) {
+            stack[sp++] = node.left + 1;
+            stack[sp++] = node.left;
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            int pi = sc.order[i];
+            if (sc.prims[pi].body == skipBody) continue;
+            int mask = rtIntersectPrim(sc.prims[pi], pi, rp, active);
+            if (anyHit && mask) {                       // raio de sombra já ocluído: desliga
+                active = _mm_andnot_ps(_mm_castsi128_ps(_mm_setr_epi32(mask & 1 ? -1 : 0, mask & 2 ? -1 : 0,
+                                                                        mask & 4 ? -1 : 0, mask & 8 ? -1 : 0)), active);
+                if (!_mm_movemask_ps(active)) return;
+            }
+        }
+    }
+}
+
+inline float rtRandom(uint32_t& state) {                // xorshift32 em [0,1)
+    state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+    return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+// Sombreia um ponto atingido (mesma iluminação do GL_LIGHT0, por pixel) e
+// escreve a cor em out. visibility = 0 quando o raio de sombra foi bloqueado.
+struct RtHit {
+    float pos[3], normal[3];
+    int prim;
+};
+
+void rtShade(const RtScene& sc, const RtHit& hit, float visibility, float out[3]) {
+    const RtPrim& p = sc.prims[hit.prim];
+    const BodyInstance& b = sc.bodies[p.body];
+    if (p.type == RT_RING) {                 // anel sem iluminação, só escurece na sombra de Saturno
+        const float ring[3] = {0.8f, 0.8f, 0.6f};
+        for (int c = 0; c < 3; ++c) out[c] = ring[c] * (0.35f + 0.65f * visibility);
+        return;
+    }
+    // coordenadas de textura no espaço local (desfaz a rotação de mundo: transposta)
+    float local[3], texel[3];
+    for (int k = 0; k < 3; ++k)
+        local[k] = b.rot[k * 3] * hit.normal[0] + b.rot[k * 3 + 1] * hit.normal[1] + b.rot[k * 3 + 2] * hit.normal[2];
+    if (b.texture >= 0) {
+        float u, v;
+        sphereTexCoord(local, &u, &v);
+        sampleTexture(cpuTextures[b.texture], u, v, texel);
+    } else {
+        for (int c = 0; c < 3; ++c) texel[c] = b.tint[c];
+    }
+    if (b.emissive) {                        // Sol: emissão satura a iluminação
+        for (int c = 0; c < 3; ++c) out[c] = texel[c];
+        return;
+    }
+    const float globalAmbient = 0.05f, matSpecular = 0.8f;
+    const Light& light = sunLight();
+    const float* sunPos = sc.bodies[0].pos;   // fora da origem depois de um rebase (worldOrigin)
+    float L[3] = {sunPos[0] - hit.pos[0], sunPos[1] - hit.pos[1], sunPos[2] - hit.pos[2]};
+    float dist = sqrtf(L[0]*L[0] + L[1]*L[1] + L[2]*L[2]);
+    for (int c = 0; c < 3; ++c) L[c] /= dist;
+    float att = 1.0f / (1.0f + lightLinearAtt * dist + lightQuadraticAtt * dist * dist);
+    float ndotl = std::max(0.0f, hit.normal[0]*L[0] + hit.normal[1]*L[1] + hit.normal[2]*L[2]);
+    float spec = 0.0f;
+    if (ndotl > 0.0f) {
+        float V[3] = {sc.eye[0] - hit.pos[0], sc.eye[1] - hit.pos[1], sc.eye[2] - hit.pos[2]};
+        float vl = sqrtf(V[0]*V[0] + V[1]*V[1] + V[2]*V[2]);
+        float H[3] = {L[0] + V[0] / vl, L[1] + V[1] / vl, L[2] + V[2] / vl};
+        float hl = sqrtf(H[0]*H[0] + H[1]*H[1] + H[2]*H[2]);
+        float ndoth = (hit.normal[0]*H[0] + hit.normal[1]*H[1] + hit.normal[2]*H[2]) / hl;
+        if (ndoth > 0.0f) spec = powf(ndoth, 50.0f);
+    }
+    for (int c = 0; c < 3; ++c) {
+        float col = globalAmbient + att * (light.ambient[c] + visibility * (light.diffuse[c] * ndotl + light.specular[c] * matSpecular * spec));
+        out[c] = std::min(col, 1.0f) * texel[c];
+    }
+}
+
+void rtRenderTile(void* ctx, int tile) {
+    RtScene& sc = *(RtScene*)ctx;
+    int tilesX = (sc.width + RT_TILE - 1) / RT_TILE;
+    int x0 = (tile % tilesX) * RT_TILE, y0 = (tile / tilesX) * RT_TILE;
+    int x1 = std::min(x0 + RT_TILE, sc.width), y1 = std::min(y0 + RT_TILE, sc.height);
+    long long rays = 0;
+    const BodyInstance& sun = sc.bodies[0];
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            uint32_t rng = (uint32_t)(y * 9781 + x * 6271) | 1u;
+            float accum[3] = {0, 0, 0};
+            float coverage = 0.0f;
+            for (int round = 0; round < sc.spp / 4; ++round) {
+                // 4 subamostras estratificadas (2x2) do pixel = um pacote
+                RayPacket rp;
+                float dx[4], dy[4], dz[4];
+                for (int lane = 0; lane < 4; ++lane) {
+                    float sx = x + ((lane & 1) + rtRandom(rng)) * 0.5f;
+                    float sy = y + ((lane >> 1) + rtRandom(rng)) * 0.5f;
+                    float px = (2.0f * sx / sc.width - 1.0f) * sc.tanHalfFov * sc.aspect;
+                    float py = (2.0f * sy / sc.height - 1.0f) * sc.tanHalfFov;
+                    float d[3];
+                    for (int a = 0; a < 3; ++a) d[a] = sc.forward[a] + px * sc.right[a] + py * sc.up[a];
+                    float l = sqrtf(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+                    dx[lane] = d[0] / l; dy[lane] = d[1] / l; dz[lane] = d[2] / l;
+                }
+                rp.ox = _mm_set1_ps(sc.eye[0]); rp.oy = _mm_set1_ps(sc.eye[1]); rp.oz = _mm_set1_ps(sc.eye[2]);
+                rp.dx = _mm_loadu_ps(dx); rp.dy = _mm_loadu_ps(dy); rp.dz = _mm_loadu_ps(dz);
+                rp.tmax = _mm_set1_ps(1e30f);
+                rtTrace(sc, rp, 0xF, false, -1);
+                rays += 4;
+
+                // pontos atingidos + raios de sombra até um ponto amostrado do Sol
+                float tl[4];
+                _mm_storeu_ps(tl, rp.tmax);
+                RtHit hits[4];
+                RayPacket shadow;
+                float sox[4], soy[4], soz[4], sdx[4], sdy[4], sdz[4], stm[4];
+                int shadowMask = 0;
+                for (int lane = 0; lane < 4; ++lane) {
+                    hits[lane].prim = rp.prim[lane];
+                    sox[lane] = soy[lane] = soz[lane] = 0; sdx[lane] = 1; sdy[lane] = sdz[lane] = 0; stm[lane] = 0;
+                    if (rp.prim[lane] < 0) continue;
+                    const RtPrim& p = sc.prims[rp.prim[lane]];
+                    RtHit& h = hits[lane];
+                    float d[3] = {dx[lane], dy[lane], dz[lane]};
+                    for (int a = 0; a < 3; ++a) h.pos[a] = sc.eye[a] + d[a] * tl[lane];
+                    if (p.type == RT_SPHERE) {
+                        for (int a = 0; a < 3; ++a) h.normal[a] = (h.pos[a] - p.center[a]) / p.radius;
+                    } else {
+                        float s = (d[0]*p.normal[0] + d[1]*p.normal[1] + d[2]*p.normal[2]) > 0 ? -1.0f : 1.0f;
+                        for (int a = 0; a < 3; ++a) h.normal[a] = p.normal[a] * s;
+                    }
+                    if (sc.bodies[p.body].emissive) continue;
+                    // ponto uniforme na esfera do Sol, levado para o hemisfério voltado ao ponto
+                    float z = 2.0f * rtRandom(rng) - 1.0f, phi = 2.0f * (float)M_PI * rtRandom(rng);
+                    float r = sqrtf(std::max(0.0f, 1.0f - z * z));
+                    float sp[3] = {r * cosf(phi), r * sinf(phi), z};
+                    float toHit[3] = {h.pos[0] - sun.pos[0], h.pos[1] - sun.pos[1], h.pos[2] - sun.pos[2]};
+                    if (sp[0]*toHit[0] + sp[1]*toHit[1] + sp[2]*toHit[2] < 0) for (int a = 0; a < 3; ++a) sp[a] = -sp[a];
+                    float to[3], len = 0;
+                    for (int a = 0; a < 3; ++a) { to[a] = sun.pos[a] + sp[a] * sun.radius - h.pos[a]; len += to[a] * to[a]; }
+                    len = sqrtf(len);
+                    sox[lane] = h.pos[0] + h.normal[0] * RT_EPS;
+                    soy[lane] = h.pos[1] + h.normal[1] * RT_EPS;
+                    soz[lane] = h.pos[2] + h.normal[2] * RT_EPS;
+                    sdx[lane] = to[0] / len; sdy[lane] = to[1] / len; sdz[lane] = to[2] / len;
+                    stm[lane] = len;
+                    shadowMask |= 1 << lane;
+                }
+                float visibility[4] = {1, 1, 1, 1};
+                if (shadowMask) {
+                    shadow.ox = _mm_loadu_ps(sox); shadow.oy = _mm_loadu_ps(soy); shadow.oz = _mm_loadu_ps(soz);
+                    shadow.dx = _mm_loadu_ps(sdx); shadow.dy = _mm_loadu_ps(sdy); shadow.dz = _mm_loadu_ps(sdz);
+                    shadow.tmax = _mm_loadu_ps(stm);
+                    rtTrace(sc, shadow, shadowMask, true, 0);
+                    for (int lane = 0; lane < 4; ++lane)
+                        if (shadow.prim[lane] >= 0) visibility[lane] = 0.0f;
+                    rays += __builtin_popcount(shadowMask);
+                }
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (hits[lane].prim < 0) continue;
+                    float c[3];
+                    rtShade(sc, hits[lane], visibility[lane], c);
+                    for (int a = 0; a < 3; ++a) accum[a] += c[a];
+                    coverage += 1.0f;
+                }
+            }
+            float inv = 1.0f / sc.spp;
+            uint32_t alpha = (uint32_t)(coverage * inv * 255.0f + 0.5f);   // cobertura (para as estrelas)
+            sc.pixels[(size_t)y * sc.width + x] =
+                (swPack(accum[0] * inv, accum[1] * inv, accum[2] * inv) & 0x00FFFFFFu) | alpha << 24;
+        }
+    }
+    sc.rays += rays;
+}
+
+RtScene rtScene;
+std::vector<uint32_t> rtPixels;
+
+// Renderiza a cena em rtPixels (linha 0 embaixo); spp = amostras por pixel
+// (múltiplo de 4). Imprime o desempenho em Mrays/s.
+void renderRayTraced(int width, int height, int spp) {
+    TRACE_SCOPE("ray tracing");
+    loadCpuTextures();
+    startThreadPool();
+    spp = std::max(4, spp / 4 * 4);
+    rtPixels.assign((size_t)width * height, 0);
+    RtScene& sc = rtScene;
+    rtBuildScene(sc, width, height, spp);
+    sc.pixels = rtPixels.data();
+
+    double t0 = nowMs();
+    int tiles = ((width + RT_TILE - 1) / RT_TILE) * ((height + RT_TILE - 1) / RT_TILE);
+    parallelFor(tiles, rtRenderTile, &sc);
+    double ms = nowMs() - t0;
+
+    // estrelas ao fundo, onde os raios não atingiram nada
+    Mat4 vp = mat4Mul(mat4Perspective(60.0f, (float)width / height, sceneNear, sceneFar), mat4LookAt(sc.eye, sc.center, sc.worldUp));
+    for (int i = 0; i < NUM_STARS; ++i) {
+        float p[4] = {stars[i].x, stars[i].y, stars[i].z, 1.0f}, c[4];
+        for (int k = 0; k < 3; ++k) p[k] += trueScale ? sc.eye[k] : sc.bodies[0].pos[k];
+        mat4Apply(vp, p, c);
+        if (c[3] <= 0.0f) continue;
+        int sx = (int)floorf((c[0] / c[3] * 0.5f + 0.5f) * width);
+        int sy = (int)floorf((c[1] / c[3] * 0.5f + 0.5f) * height);
+        if (sx < 0 || sy < 0 || sx >= width || sy >= height) continue;
+        uint32_t& px = rtPixels[(size_t)sy * width + sx];
+        float bg = 1.0f - (px >> 24) / 255.0f;
+        float tw = 0.85f + 0.15f * (0.5f + 0.5f * sinf(twinklePhase() + stars[i].phase));
+        float g = stars[i].base * tw * bg;
+        float r = ((px & 0xFF) / 255.0f) + g, gg = (((px >> 8) & 0xFF) / 255.0f) + g, b = (((px >> 16) & 0xFF) / 255.0f) + g;
+        px = swPack(std::min(r, 1.0f), std::min(gg, 1.0f), std::min(b, 1.0f));
+    }
+    for (size_t i = 0; i < rtPixels.size(); ++i) rtPixels[i] |= 0xFF000000u;
+
+    printf("Ray tracing %dx%d, %d spp, %d threads: %.1f ms, %.2f Mrays/s (%lld raios)\n",
+           width, height, spp, poolThreads(), ms, sc.rays.load() / (ms * 1000.0), sc.rays.load());
+}
+
+// Tecla 'R': renderiza a vista atual com o ray tracer e salva raytrace_<hora>.ppm
+void saveRayTracedStill() {
+    renderRayTraced(winWidth, winHeight, 16);
+    char path[64];
+    snprintf(path, sizeof(path), "raytrace_%ld.ppm", (long)time(NULL));
+    if (writePPM(path, rtPixels.data(), winWidth, winHeight)) printf("Imagem salva em %s\n", path);
+}
@@ -0,0 +1,12 @@
+// Ray tracer em CPU (imagens paradas de referência)
+#ifndef SOLAR_RAYTRACE_H
+#define SOLAR_RAYTRACE_H
+
+#include "common.h"
+
+extern std::vector<uint32_t> rtPixels;
+
+void renderRayTraced(int width, int height, int spp);
+void saveRayTracedStill();
+
+#endif
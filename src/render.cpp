@@ -0,0 +1,826 @@
+#include "render.h"
+
+#include <time.h>
+#include <png.h>
+
+#include "app.h"
+#include "atmosphere.h"
+#include "belts.h"
+#include "bodies.h"
+#include "comets.h"
+#include "hdr.h"
+#include "runtime.h"
+#include "shadows.h"
+#include "software.h"
+#include "stars.h"
+#include "texture.h"
+
+const char* depthModeNames[DEPTH_MODES] = {"padrao", "reversed-z", "log"};
+int depthMode = -1;
+float sceneNear = 0.5f, sceneFar = 300.0f;
+float lightLinearAtt = 0.001f, lightQuadraticAtt = 0.0001f;
+float renderScale = 1.0f;
+
+bool hasExtension(const char* name) {
+    return gluCheckExtension((const GLubyte*)name, glGetString(GL_EXTENSIONS));
+}
+unsigned bodiesVisible = 0;
+unsigned bodiesSoon = 0;
+
+void initLighting() {
+    glEnable(GL_LIGHTING);
+    glEnable(GL_LIGHT0);
+
+    // Ambiente global aumentado um pouco
+    GLfloat globalAmbient[] = {0.05f, 0.05f, 0.05f, 1.0f}; // Aumentado de 0.02 para 0.05
+    glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
+
+    // Cores da fonte de luz: componente Light do Sol
+    const Light& light = sunLight();
+    GLfloat lightAmbient[]  = {light.ambient[0], light.ambient[1], light.ambient[2], 1.0f};
+    GLfloat lightDiffuse[]  = {light.diffuse[0], light.diffuse[1], light.diffuse[2], 1.0f};
+    GLfloat lightSpecular[] = {light.specular[0], light.specular[1], light.specular[2], 1.0f};
+
+    glLightfv(GL_LIGHT0, GL_AMBIENT, lightAmbient);
+    glLightfv(GL_LIGHT0, GL_DIFFUSE, lightDiffuse);
+    glLightfv(GL_LIGHT0, GL_SPECULAR, lightSpecular);
+
+    // Atenuação mantida (desligada em escala real)
+    glLightf(GL_LIGHT0, GL_CONSTANT_ATTENUATION, 1.0f);
+    glLightf(GL_LIGHT0, GL_LINEAR_ATTENUATION, lightLinearAtt);
+    glLightf(GL_LIGHT0, GL_QUADRATIC_ATTENUATION, lightQuadraticAtt);
+
+    glEnable(GL_COLOR_MATERIAL);
+    glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+}
+
+// Liga/desliga iluminação e textura; no modo de depth logarítmico, com
+// sombras ou em HDR o shader da cena substitui o pipeline fixo e recebe o
+// mesmo estado por uniforms
+GLuint sceneProgram = 0;
+GLint sceneLightingLoc = -1, sceneTexturingLoc = -1, sceneFcoefLoc = -1;
+GLint sceneShadowsLoc = -1, sceneViewToWorldLoc = -1, sceneUnlitShadowLoc = -1, sceneColorLimitLoc = -1;
+bool sceneProgramActive = false;
+
+void setLighting(bool on) {
+    if (on) glEnable(GL_LIGHTING); else glDisable(GL_LIGHTING);
+    if (sceneProgramActive) glUniform1i(sceneLightingLoc, on);
+}
+
+void setTexturing(bool on) {
+    if (on) glEnable(GL_TEXTURE_2D); else glDisable(GL_TEXTURE_2D);
+    if (sceneProgramActive) glUniform1i(sceneTexturingLoc, on);
+}
+
+// Quanto a sombra escurece geometria sem iluminação (anel de Saturno)
+void setUnlitShadow(float amount) {
+    if (sceneProgramActive) glUniform1f(sceneUnlitShadowLoc, amount);
+}
+
+// Desenhar anel de Saturno
+void drawRing(float innerRadius, float outerRadius) {
+    int numSegments = 100;
+    setLighting(false);
+    setUnlitShadow(0.65f);      // na sombra de Saturno fica com 35% (igual ao ray tracer)
+    glColor3f(0.8f, 0.8f, 0.6f);// tom amarelado
+    glBegin(GL_QUAD_STRIP);
+    for (int i=0; i<=numSegments; i++) {
+        float angle = 2.0f * M_PI * i / numSegments;
+        float xInner = innerRadius * cos(angle);
+        float zInner = innerRadius * sin(angle);
+        float xOuter = outerRadius * cos(angle);
+        float zOuter = outerRadius * sin(angle);
+        glVertex3f(xInner, 0, zInner);
+        glVertex3f(xOuter, 0, zOuter);
+    }
+    glEnd();
+    setUnlitShadow(0.0f);
+    setLighting(true);
+}
+
+// Quadric das esferas (com coordenadas de textura e normais suaves), criado
+// uma vez: gluNewQuadric aloca, e o Sol e os planetas são desenhados a cada quadro
+GLUquadric* sphereQuadric() {
+    static GLUquadric* quad = NULL;
+    if (!quad) {
+        quad = gluNewQuadric();
+        gluQuadricTexture(quad, GL_TRUE);
+        gluQuadricNormals(quad, GLU_SMOOTH);
+    }
+    return quad;
+}
+
+// Sol - com material emissivo para brilhar intensamente (offset = posição relativa à câmera)
+void drawSun(const float offset[3]) {
+    TRACE_SCOPE("sol");
+    glPushMatrix();
+    glTranslatef(offset[0], offset[1], offset[2]);
+    setTexturing(true);
+    glBindTexture(GL_TEXTURE_2D, sunTexture);
+    
+    // Material emissivo - faz o Sol brilhar com sua própria luz
+    const Light& light = sunLight();
+    GLfloat sunEmission[] = {light.emission[0], light.emission[1], light.emission[2], 1.0f};  // Amarelo brilhante
+    GLfloat sunDiffuse[]  = {1.0f, 1.0f, 0.8f, 1.0f};  // Cor difusa
+    glMaterialfv(GL_FRONT, GL_EMISSION, sunEmission);
+    glMaterialfv(GL_FRONT, GL_DIFFUSE, sunDiffuse);
+    
+    // Desenha o Sol COM iluminação, mas com emissão própria
+    gluSphere(sphereQuadric(), sunRadius, 50, 50);
+    
+    // Reseta a emissão para os planetas não brilharem
+    GLfloat noEmission[] = {0.0f, 0.0f, 0.0f, 1.0f};
+    glMaterialfv(GL_FRONT, GL_EMISSION, noEmission);
+    
+    setTexturing(false);
+    glPopMatrix();
+}
+
+// Órbitas (círculos no plano XZ): os vértices não mudam, então são gerados uma vez
+const int ORBIT_SEGMENTS = 800;                     // resolução de cada órbita
+float orbitVerts[8][ORBIT_SEGMENTS * 3];
+
+void initOrbits() {
+    for(int i=0; i<8; i++)
+        for(int j=0; j<ORBIT_SEGMENTS; j++) {
+            float theta = 2.0f * M_PI * (float)j / (float)ORBIT_SEGMENTS;
+            orbitVerts[i][j * 3]     = orbitRadii[i] * cos(theta);
+            orbitVerts[i][j * 3 + 1] = 0;
+            orbitVerts[i][j * 3 + 2] = orbitRadii[i] * sin(theta);
+        }
+}
+
+void drawOrbits(const float offset[3]) {
+    TRACE_SCOPE("orbitas");
+    glPushMatrix();
+    glTranslatef(offset[0], offset[1], offset[2]);  // centro das órbitas relativo à câmera
+    setLighting(false);                             // linhas simples, sem iluminação
+    glColor3f(1.0f, 1.0f, 1.0f);                    // cor das órbitas
+    glLineWidth(renderScale);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, orbitVerts);
+    for(int i=0; i<8; i++)
+        glDrawArrays(GL_LINE_LOOP, i * ORBIT_SEGMENTS, ORBIT_SEGMENTS);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    setLighting(true);                              // volta iluminação
+    glPopMatrix();
+}
+
+// Planetas e luas: a transformação vem do grafo de cena (posição em double
+// menos a câmera, rotação de mundo em float); anel e materiais como antes.
+// visible: bit i = corpo i dentro do frustum da vista; origin = câmera (double).
+void drawPlanets(const BodyInstance* bodies, int count, unsigned visible, const double origin[3]) {
+    TRACE_SCOPE("planetas");
+    for (int i = 1; i < count; i++) {
+        if (!(visible & (1u << i))) continue;
+        const BodyInstance& b = bodies[i];
+
+        glPushMatrix();
+            glTranslatef((float)(b.world[0] - origin[0]), (float)(b.world[1] - origin[1]), (float)(b.world[2] - origin[2]));
+
+            if (b.hasRing) {                             // anel (não gira com o corpo)
+                glRotatef(b.ring.tiltDeg, 1, 0, 0);
+                drawRing(b.radius * b.ring.inner, b.radius * b.ring.outer);
+                glRotatef(-b.ring.tiltDeg, 1, 0, 0);
+            }
+
+            const GLfloat world[16] = {b.rot[0], b.rot[1], b.rot[2], 0, b.rot[3], b.rot[4], b.rot[5], 0,
+                                       b.rot[6], b.rot[7], b.rot[8], 0, 0, 0, 0, 1};
+            glMultMatrixf(world);                        // rotação própria (dia/noite) / órbita sincronizada
+
+            // --- materiais + textura (modulados pela luz) ---
+            glColor3fv(b.tint);
+
+            GLfloat matDiffuse[]  = {1.0f, 1.0f, 1.0f, 1.0f};
+            GLfloat matAmbient[]  = {0.6f, 0.6f, 0.6f, 1.0f};  // Aumentado para refletir mais luz ambiente
+            GLfloat matSpecular[] = {0.8f, 0.8f, 0.8f, 1.0f};  // Especular mantido
+            glMaterialfv(GL_FRONT, GL_AMBIENT,  matAmbient);
+            glMaterialfv(GL_FRONT, GL_DIFFUSE,  matDiffuse);
+            glMaterialfv(GL_FRONT, GL_SPECULAR, matSpecular);
+            glMaterialf (GL_FRONT, GL_SHININESS, 50.0f);       // Brilho moderado
+
+            bool textured = b.texture > 0;
+            if (textured) {
+                setTexturing(true);                             // ativa textura do planeta
+                glBindTexture(GL_TEXTURE_2D, planetTextures[b.texture - 1]);
+            }
+
+            gluSphere(sphereQuadric(), b.radius, 30, 30);       // desenha esfera
+
+            if (textured) setTexturing(false);
+        glPopMatrix();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Várias vistas por quadro (vista geral + câmeras que acompanham planetas).
+// Tudo o que não depende da câmera (corpos, brilho das estrelas) e o descarte
+// por frustum de todas as vistas é calculado uma vez em buildFrameScene();
+// cada vista depois só ajusta viewport/matrizes e envia o que enxerga.
+const int MAX_VIEWS = 9;
+
+struct FrameScene {
+    BodyInstance* bodies;         // na arena do quadro
+    int bodyCount;
+    float starColors[NUM_STARS * 3];
+    View views[MAX_VIEWS];
+    unsigned visible[MAX_VIEWS];  // bit i = corpo i dentro do frustum da vista
+    unsigned soon;                // corpos que a vista principal verá em breve (pose prevista)
+    int viewCount;
+};
+FrameScene frameScene;
+
+// 0 = só a vista geral, 1 = geral + planetas internos em miniatura,
+// 2 = grade 3x3 (geral no centro + os 8 planetas). Tecla 'v' ou --views=N.
+int viewLayout = 0;
+
+// Câmera que acompanha o corpo b: levemente de lado e do lado iluminado
+void followView(View& v, const BodyInstance& b) {
+    double len = sqrt(b.world[0] * b.world[0] + b.world[2] * b.world[2]);
+    double dx = b.world[0] / len, dz = b.world[2] / len;    // direção Sol -> corpo
+    double back = -0.6 * dx - 0.8 * dz, side = -0.6 * dz + 0.8 * dx;
+    double d = b.radius * 4.0;
+    v.eye[0] = b.world[0] + back * d;
+    v.eye[1] = b.world[1] + b.radius * 1.2;
+    v.eye[2] = b.world[2] + side * d;
+    for (int k = 0; k < 3; ++k) v.center[k] = b.world[k];
+    v.fovy = 45.0f;
+}
+
+void setupViews(FrameScene& fs, int layout, int width, int height) {
+    View overview = {0, 0, width, height, {0, 0, 0}, {0, 0, 0}, {0, 1, 0}, 60.0f, -1};
+    double up[3];
+    cameraViewD(overview.eye, overview.center, up);
+    for (int k = 0; k < 3; ++k) overview.up[k] = (float)up[k];
+    fs.viewCount = 0;
+    if (layout == 2) {
+        int cw = width / 3, ch = height / 3, planet = 1;
+        for (int cell = 0; cell < 9; ++cell) {
+            View v = overview;
+            v.x = (cell % 3) * cw;
+            v.y = (2 - cell / 3) * ch;
+            v.w = cell % 3 == 2 ? width - 2 * cw : cw;
+            v.h = cell / 3 == 0 ? height - 2 * ch : ch;
+            if (cell != 4) {
+                v.follow = planet++;
+                followView(v, fs.bodies[v.follow]);
+            }
+            fs.views[fs.viewCount++] = v;
+        }
+        return;
+    }
+    fs.views[fs.viewCount++] = overview;
+    if (layout == 1) {                                       // miniaturas na coluna da direita
+        int ih = height / 4, iw = ih * 4 / 3;
+        for (int i = 0; i < 4; ++i) {
+            View v = overview;
+            v.x = width - iw;
+            v.y = height - (i + 1) * ih;
+            v.w = iw;
+            v.h = ih;
+            v.follow = i + 1;
+            followView(v, fs.bodies[v.follow]);
+            fs.views[fs.viewCount++] = v;
+        }
+    }
+}
+
+// Planos do frustum (Gribb/Hartmann) e teste de esfera
+void frustumPlanes(const Mat4& vp, float planes[6][4]) {
+    for (int p = 0; p < 6; ++p) {
+        int axis = p / 2;
+        float sign = (p & 1) ? -1.0f : 1.0f;
+        for (int k = 0; k < 4; ++k) planes[p][k] = vp.m[k * 4 + 3] + sign * vp.m[k * 4 + axis];
+    }
+}
+
+bool sphereInFrustum(const float planes[6][4], const float c[3], float r) {
+    for (int p = 0; p < 6; ++p) {
+        const float* n = planes[p];
+        float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (n[0] * c[0] + n[1] * c[1] + n[2] * c[2] + n[3] < -r * len) return false;
+    }
+    return true;
+}
+
+// Atualização da cena e descarte de todas as vistas, uma vez por quadro
+const int PREDICT_TICKS[2] = {30, 60};       // poses previstas: daqui a 0,5 s e 1 s
+
+// Descarte relativo ao olho (em float, sem perder precisão em escala real)
+unsigned cullBodies(const BodyInstance* bodies, int count, const double eye[3], const double center[3], const float up[3],
+                    float fovy, float aspect) {
+    const float origin[3] = {0, 0, 0};
+    float dir[3] = {(float)(center[0] - eye[0]), (float)(center[1] - eye[1]), (float)(center[2] - eye[2])};
+    Mat4 vp = mat4Mul(mat4Perspective(fovy, aspect, sceneNear, sceneFar), mat4LookAt(origin, dir, up));
+    float planes[6][4];
+    frustumPlanes(vp, planes);
+    unsigned mask = 0;
+    for (int i = 0; i < count; ++i) {
+        const BodyInstance& b = bodies[i];
+        float r = b.hasRing ? b.radius * b.ring.outer : b.radius;   // o anel vai além do raio
+        float rel[3] = {(float)(b.world[0] - eye[0]), (float)(b.world[1] - eye[1]), (float)(b.world[2] - eye[2])};
+        if (sphereInFrustum(planes, rel, r)) mask |= 1u << i;
+    }
+    return mask;
+}
+
+void buildFrameScene(int layout, int width, int height) {
+    TRACE_SCOPE("cena: montar");
+    FrameScene& fs = frameScene;
+    fs.bodies = arenaArray<BodyInstance>(NUM_BODIES);
+    fs.bodyCount = computeBodies(fs.bodies);
+    computeStarColors(fs.starColors);
+    setupViews(fs, layout, width, height);
+    for (int v = 0; v < fs.viewCount; ++v) {
+        const View& view = fs.views[v];
+        fs.visible[v] = cullBodies(fs.bodies, fs.bodyCount, view.eye, view.center, view.up, view.fovy, (float)view.w / view.h);
+    }
+
+    // Caminho previsto da câmera principal: o que entrar no frustum nas poses
+    // futuras (com os corpos também nas posições futuras) é pré-carregado
+    const View& main = fs.views[0];
+    unsigned visibleAny = 0;
+    for (int v = 0; v < fs.viewCount; ++v) visibleAny |= fs.visible[v];
+    fs.soon = 0;
+    for (int p = 0; p < 2; ++p) {
+        double eye[3], center[3], up[3];
+        predictCamera(PREDICT_TICKS[p], eye, center, up);
+        float upf[3] = {(float)up[0], (float)up[1], (float)up[2]};
+        BodyInstance* ahead = arenaArray<BodyInstance>(fs.bodyCount);
+        for (int i = 0; i < fs.bodyCount; ++i) {
+            ahead[i] = fs.bodies[i];
+            bodyPositionAhead(i, PREDICT_TICKS[p], ahead[i].world, &ahead[i].radius);
+        }
+        fs.soon |= cullBodies(ahead, fs.bodyCount, eye, center, upf, main.fovy, (float)main.w / main.h);
+    }
+    fs.soon &= ~visibleAny;
+    bodiesVisible = visibleAny;
+    bodiesSoon = fs.soon;
+}
+
+// Envia uma vista (a projeção e o viewport já estão ajustados). A câmera fica
+// na origem: as posições são subtraídas do olho em double e só o resultado
+// (pequeno perto da câmera) vai para a GPU em float.
+void submitView(const FrameScene& fs, int index) {
+    TRACE_SCOPE("vista");
+    const View& v = fs.views[index];
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();                                   // reseta matriz modelview
+    gluLookAt(0, 0, 0, v.center[0] - v.eye[0], v.center[1] - v.eye[1], v.center[2] - v.eye[2], v.up[0], v.up[1], v.up[2]);
+    if (sceneProgramActive) {                           // rotação inversa da câmera (direção no cube map)
+        GLfloat mv[16], viewToWorld[9];
+        glGetFloatv(GL_MODELVIEW_MATRIX, mv);
+        for (int c = 0; c < 3; ++c)
+            for (int r = 0; r < 3; ++r) viewToWorld[c * 3 + r] = mv[r * 4 + c];
+        glUniformMatrix3fv(sceneViewToWorldLoc, 1, GL_FALSE, viewToWorld);
+    }
+    float sunOffset[3] = {(float)-v.eye[0], (float)-v.eye[1], (float)-v.eye[2]};
+
+    // Céu estrelado primeiro (fundo da cena); em escala real fica preso à câmera
+    glPushMatrix();
+    if (!trueScale) glTranslatef(sunOffset[0], sunOffset[1], sunOffset[2]);
+    drawStars(fs.starColors);
+    glPopMatrix();
+
+    // Luz no centro (vinda do Sol) — precisa ser setada após a câmera
+    GLfloat lightPos[] = {sunOffset[0], sunOffset[1], sunOffset[2], 1.0f};   // luz pontual no Sol
+    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
+
+    if (fs.visible[index] & 1u) drawSun(sunOffset);
+
+    // Desenhar órbitas (opcional)
+    if (showOrbits) drawOrbits(sunOffset);
+
+    drawPlanets(fs.bodies, fs.bodyCount, fs.visible[index], v.eye);
+    drawBelts(v, v.eye);
+    drawComets(sunOffset);
+    drawAtmospheres(fs.bodies, fs.visible[index], v.eye);
+}
+
+// ---------------------------------------------------------------------------
+// Modos de depth. Reversed-Z: projeção com far infinito e depth 1 no near,
+// glClipControl(ZERO_TO_ONE) e depth em float num FBO (o framebuffer da
+// janela só tem 24 bits inteiros); a precisão do float acompanha a 1/z.
+// Log: sem glClipControl, um shader GLSL 1.20 refaz a iluminação do pipeline
+// fixo e grava gl_FragDepth = log2(1 + w) / log2(1 + far).
+struct DepthTarget {
+    GLuint fbo, color, depth;
+    int width, height;
+};
+DepthTarget depthTarget;
+
+// O mesmo shader recebe as sombras: a luz direta do Sol (difusa + especular)
+// é separada da ambiente e multiplicada pela visibilidade lida no cube map.
+const char* sceneVertexShader =
+    "#version 120\n"
+    "uniform bool lighting;\n"
+    "uniform mat3 viewToWorld;\n"
+    "uniform float colorLimit;\n"         // 1 no framebuffer de 8 bits; sem limite em HDR
+    "varying float logz;\n"
+    "varying vec3 fromSun;\n"              // do Sol ao vértice, nos eixos do mundo
+    "varying vec3 direct;\n"               // parcela da luz que a sombra bloqueia
+    "void main() {\n"
+    "    vec4 eye = gl_ModelViewMatrix * gl_Vertex;\n"
+    "    gl_Position = gl_ProjectionMatrix * eye;\n"
+    "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "    logz = 1.0 + gl_Position.w;\n"
+    "    fromSun = viewToWorld * (eye.xyz - gl_LightSource[0].position.xyz);\n"
+    "    direct = vec3(0.0);\n"
+    "    if (!lighting) { gl_FrontColor = gl_Color; return; }\n"
+    "    vec3 n = normalize(gl_NormalMatrix * gl_Normal);\n"
+    "    vec3 L = gl_LightSource[0].position.xyz - eye.xyz;\n"
+    "    float d = length(L);\n"
+    "    L /= d;\n"
+    "    float att = 1.0 / (gl_LightSource[0].constantAttenuation + gl_LightSource[0].linearAttenuation * d\n"
+    "                     + gl_LightSource[0].quadraticAttenuation * d * d);\n"
+    "    float ndl = max(dot(n, L), 0.0);\n"
+    "    vec4 c = gl_FrontMaterial.emission + gl_LightModel.ambient * gl_Color\n"   // GL_COLOR_MATERIAL
+    "           + att * gl_LightSource[0].ambient * gl_Color;\n"
+    "    vec4 dl = att * ndl * gl_LightSource[0].diffuse * gl_Color;\n"
+    "    if (ndl > 0.0) {\n"
+    "        vec3 h = normalize(L + vec3(0.0, 0.0, 1.0));\n"
+    "        dl += att * pow(max(dot(n, h), 0.0), gl_FrontMaterial.shininess)\n"
+    "              * gl_FrontMaterial.specular * gl_LightSource[0].specular;\n"
+    "    }\n"
+    "    gl_FrontColor = vec4(c.rgb, gl_Color.a);\n"
+    "    direct = clamp(c.rgb + dl.rgb, 0.0, colorLimit) - clamp(c.rgb, 0.0, colorLimit);\n"   // soma limitada como no pipeline fixo
+    "}\n";
+
+const char* sceneFragmentShader =
+    "#version 120\n"
+    "uniform bool texturing, shadows;\n"
+    "uniform sampler2D tex;\n"
+    "uniform samplerCube shadowMap;\n"
+    "uniform float fcoef, shadowBias, shadowScale, unlitShadow;\n"
+    "varying float logz;\n"
+    "varying vec3 fromSun;\n"
+    "varying vec3 direct;\n"
+    "void main() {\n"
+    "    float visible = 1.0;\n"
+    "    if (shadows) {\n"
+    "        float d = length(fromSun) * shadowScale;\n"
+    "        visible = d * (1.0 - shadowBias) > textureCube(shadowMap, fromSun).r ? 0.0 : 1.0;\n"
+    "    }\n"
+    "    vec4 c = vec4((gl_Color.rgb + direct * visible) * mix(1.0, visible, unlitShadow), gl_Color.a);\n"
+    "    if (texturing) c *= texture2D(tex, gl_TexCoord[0].st);\n"
+    "    gl_FragColor = c;\n"
+    "    gl_FragDepth = fcoef > 0.0 ? log2(logz) * fcoef : gl_FragCoord.z;\n"
+    "}\n";
+
+GLuint compileShader(GLenum type, const char* src) {
+    GLuint sh = glCreateShader(type);
+    glShaderSource(sh, 1, &src, NULL);
+    glCompileShader(sh);
+    GLint ok;
+    glGetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(sh, sizeof(log), NULL, log);
+        printf("Erro no shader: %s\n", log);
+        glDeleteShader(sh);
+        return 0;
+    }
+    return sh;
+}
+
+// Compila e liga um programa de vértice + fragmento (0 em caso de erro). Sem
+// fragmento e com 'feedback', é um passe de transform feedback (as variáveis
+// listadas vão intercaladas para o buffer)
+GLuint linkProgram(const char* vertexSrc, const char* fragmentSrc, const char* const* feedback, int feedbackCount) {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vertexSrc);
+    GLuint fs = fragmentSrc ? compileShader(GL_FRAGMENT_SHADER, fragmentSrc) : 0;
+    if (!vs || (fragmentSrc && !fs)) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return 0;
+    }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    if (fs) glAttachShader(program, fs);
+    if (feedback) glTransformFeedbackVaryings(program, feedbackCount, feedback, GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    if (fs) glDeleteShader(fs);
+    GLint ok;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+const float SHADOW_BIAS = 0.01f;      // fração da distância ao Sol (evita auto-sombra)
+
+bool initSceneProgram() {
+    if (sceneProgram) return true;
+    sceneProgram = linkProgram(sceneVertexShader, sceneFragmentShader);
+    if (!sceneProgram) return false;
+    sceneLightingLoc = glGetUniformLocation(sceneProgram, "lighting");
+    sceneTexturingLoc = glGetUniformLocation(sceneProgram, "texturing");
+    sceneFcoefLoc = glGetUniformLocation(sceneProgram, "fcoef");
+    sceneShadowsLoc = glGetUniformLocation(sceneProgram, "shadows");
+    sceneViewToWorldLoc = glGetUniformLocation(sceneProgram, "viewToWorld");
+    sceneUnlitShadowLoc = glGetUniformLocation(sceneProgram, "unlitShadow");
+    sceneColorLimitLoc = glGetUniformLocation(sceneProgram, "colorLimit");
+    glUseProgram(sceneProgram);
+    glUniform1i(glGetUniformLocation(sceneProgram, "tex"), 0);
+    glUniform1i(glGetUniformLocation(sceneProgram, "shadowMap"), 3);
+    glUniform1f(glGetUniformLocation(sceneProgram, "shadowBias"), SHADOW_BIAS);
+    glUseProgram(0);
+    return true;
+}
+
+int glVersion() {
+    int major = 0, minor = 0;
+    const char* v = (const char*)glGetString(GL_VERSION);
+    if (v) sscanf(v, "%d.%d", &major, &minor);
+    return major * 10 + minor;
+}
+
+// Escolhe o modo de depth (com recuos) depois de criar o contexto
+void initDepthMode() {
+    if (depthMode < 0) depthMode = trueScale ? DEPTH_REVERSED : DEPTH_STANDARD;
+    if (depthMode == DEPTH_REVERSED && glVersion() < 45 && !hasExtension("GL_ARB_clip_control")) {
+        printf("Sem glClipControl: usando depth logaritmico\n");
+        depthMode = DEPTH_LOG;
+    }
+    if (depthMode == DEPTH_LOG && (glVersion() < 20 || !initSceneProgram())) {
+        printf("Sem GLSL 1.20: usando depth padrao\n");
+        depthMode = DEPTH_STANDARD;
+    }
+    if (depthMode == DEPTH_REVERSED) sceneFar = 1e10f;      // só para o descarte: a projeção é infinita
+    printf("Depth: %s (near %g, far %g)\n", depthModeNames[depthMode], sceneNear, sceneFar);
+}
+
+// Projeção fora do eixo (como glFrustum com near = sceneNear) no modo atual
+void setFrustum(float left, float right, float bottom, float top) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    if (depthMode == DEPTH_REVERSED) {          // far infinito, z_ndc = near / -z_olho
+        float n = sceneNear;
+        GLfloat m[16] = {2 * n / (right - left), 0, 0, 0,
+                         0, 2 * n / (top - bottom), 0, 0,
+                         (right + left) / (right - left), (top + bottom) / (top - bottom), 0, -1,
+                         0, 0, n, 0};
+        glLoadMatrixf(m);
+    } else {
+        glFrustum(left, right, bottom, top, sceneNear, sceneFar);
+    }
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void setPerspective(float fovy, float aspect) {
+    float top = sceneNear * tanf(fovy * (float)M_PI / 360.0f);
+    setFrustum(-top * aspect, top * aspect, -top, top);
+}
+
+// Estado de depth do modo atual (clip control, teste e valor de limpeza) e o
+// shader da cena quando há depth logarítmico, sombras ou HDR
+void beginDepthState() {
+    if (depthMode == DEPTH_REVERSED) {
+        glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        glClearDepth(0.0);
+        glDepthFunc(GL_GREATER);
+    }
+    if (depthMode == DEPTH_LOG || shadowsActive() || hdrActive()) {
+        glUseProgram(sceneProgram);
+        glUniform1f(sceneFcoefLoc, depthMode == DEPTH_LOG ? 1.0f / log2f(sceneFar + 1.0f) : 0.0f);
+        glUniform1i(sceneShadowsLoc, shadowsActive());
+        glUniform1f(sceneUnlitShadowLoc, 0.0f);
+        glUniform1f(sceneColorLimitLoc, hdrActive() ? 65504.0f : 1.0f);
+        if (shadowsActive()) {
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_CUBE_MAP, shadowMap.cube);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        sceneProgramActive = true;
+        setLighting(true);
+        setTexturing(false);
+    }
+    if (hdrActive()) glClampColor(GL_CLAMP_VERTEX_COLOR, GL_FALSE);    // cores acima de 1 chegam ao alvo
+}
+
+void endDepthState() {
+    if (depthMode == DEPTH_REVERSED) {
+        glClipControl(GL_LOWER_LEFT, GL_NEGATIVE_ONE_TO_ONE);
+        glClearDepth(1.0);
+        glDepthFunc(GL_LESS);
+    }
+    if (sceneProgramActive) {
+        glUseProgram(0);
+        sceneProgramActive = false;
+    }
+    glClampColor(GL_CLAMP_VERTEX_COLOR, GL_TRUE);
+}
+
+// FBO com depth em float do tamanho da janela (reversed-Z)
+void bindDepthTarget(int width, int height) {
+    DepthTarget& dt = depthTarget;
+    if (!dt.fbo) {
+        glGenFramebuffers(1, &dt.fbo);
+        glGenRenderbuffers(1, &dt.color);
+        glGenRenderbuffers(1, &dt.depth);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, dt.fbo);
+    if (dt.width != width || dt.height != height) {
+        glBindRenderbuffer(GL_RENDERBUFFER, dt.color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, dt.depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, dt.color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, dt.depth);
+        dt.width = width;
+        dt.height = height;
+    }
+}
+
+// Cena completa pelo pipeline do OpenGL: todas as vistas do layout atual
+void renderSceneGL() {
+    gpuTimersNewFrame();
+    buildFrameScene(viewLayout, winWidth, winHeight);
+    updateShadowMap(frameScene.bodies, frameScene.bodyCount);
+    updateBelts();
+    gpuTimerBegin(GPU_PASS_SCENE);
+    bool hdr = hdrActive();
+    if (hdr) bindHdrTarget(winWidth, winHeight);
+    else if (depthMode == DEPTH_REVERSED) bindDepthTarget(winWidth, winHeight);
+    beginDepthState();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // limpa buffers de cor e profundidade
+    glEnable(GL_SCISSOR_TEST);
+    for (int i = 0; i < frameScene.viewCount; ++i) {
+        const View& v = frameScene.views[i];
+        glViewport(v.x, v.y, v.w, v.h);
+        glScissor(v.x, v.y, v.w, v.h);
+        if (i > 0) glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);  // miniaturas sobre a geral
+        setPerspective(v.fovy, (float)v.w / v.h);
+        submitView(frameScene, i);
+    }
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, winWidth, winHeight);
+    endDepthState();
+    if (!hdr && depthMode == DEPTH_REVERSED) {          // copia a cor para a janela
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, winWidth, winHeight, 0, 0, winWidth, winHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    gpuTimerEnd();
+    if (hdr) {                                          // bloom + tonemapping até a janela
+        renderBloom();
+        gpuTimerBegin(GPU_PASS_TONEMAP);
+        tonemapTo(0, winWidth, winHeight, BLOOM_STRENGTH);
+        gpuTimerEnd();
+    }
+}
+
+// Copia o framebuffer do rasterizador em software para a janela
+void presentSoftwareFrame() {
+    glPushAttrib(GL_ENABLE_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glWindowPos2i(0, 0);
+    glDrawPixels(sw.width, sw.height, GL_RGBA, GL_UNSIGNED_BYTE, sw.color.data());
+    glPopAttrib();
+}
+
+// ---------------------------------------------------------------------------
+// Captura em alta resolução (pôster): a projeção do gluPerspective da janela
+// é dividida em sub-frustos; cada ladrilho é renderizado num FBO e lido para
+// uma faixa horizontal, cujas linhas vão direto para o codificador PNG. Só
+// uma faixa fica em memória, com altura limitada por POSTER_STRIP_BUDGET.
+const int    POSTER_TILE          = 2048;
+const size_t POSTER_STRIP_BUDGET  = 64u << 20;
+int posterWidth = 0, posterHeight = 0;
+const char* posterPath = "poster.png";
+
+// Codificador do pôster. O libpng sai dos erros com longjmp para o setjmp,
+// pulando os destrutores do que foi criado depois dele; por isso cada
+// chamada do libpng fica numa função própria, só com locais triviais.
+struct PosterPng {
+    FILE* f;
+    png_structp png;
+    png_infop info;
+};
+
+bool posterPngOpen(PosterPng& p, const char* path, int width, int height) {
+    p.f = fopen(path, "wb");
+    if (!p.f) { printf("Erro ao criar %s\n", path); return false; }
+    p.png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    p.info = p.png ? png_create_info_struct(p.png) : NULL;
+    if (!p.info || setjmp(png_jmpbuf(p.png))) {
+        printf("Erro ao gravar PNG: %s\n", path);
+        png_destroy_write_struct(&p.png, &p.info);
+        fclose(p.f);
+        return false;
+    }
+    png_init_io(p.png, p.f);
+    png_set_compression_level(p.png, 3);
+    png_set_IHDR(p.png, p.info, width, height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(p.png, p.info);
+    return true;
+}
+
+// Linhas da faixa, de cima para baixo (a faixa vem do glReadPixels, de baixo para cima)
+bool posterPngRows(PosterPng& p, const unsigned char* strip, int rows, size_t stride) {
+    if (setjmp(png_jmpbuf(p.png))) return false;
+    for (int r = rows - 1; r >= 0; --r) png_write_row(p.png, strip + (size_t)r * stride);
+    return true;
+}
+
+bool posterPngEnd(PosterPng& p) {
+    if (setjmp(png_jmpbuf(p.png))) return false;
+    png_write_end(p.png, NULL);
+    return true;
+}
+
+void posterPngClose(PosterPng& p) {
+    png_destroy_write_struct(&p.png, &p.info);
+    fclose(p.f);
+}
+
+bool renderPoster(int width, int height, const char* path) {
+    GLint maxRenderbuffer, maxViewport[2];
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+    int tile = std::min(POSTER_TILE, (int)std::min(maxRenderbuffer, std::min(maxViewport[0], maxViewport[1])));
+    int tileW = std::min(tile, width);
+    int stripH = (int)std::min((size_t)tile, std::max((size_t)1, POSTER_STRIP_BUDGET / ((size_t)width * 3)));
+    stripH = std::min(stripH, height);
+
+    PosterPng out;
+    if (!posterPngOpen(out, path, width, height)) return false;
+
+    GLuint fbo, rb[2];
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(2, rb);
+    glBindRenderbuffer(GL_RENDERBUFFER, rb[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, tileW, stripH);
+    glBindRenderbuffer(GL_RENDERBUFFER, rb[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, depthMode == DEPTH_REVERSED ? GL_DEPTH_COMPONENT32F : GL_DEPTH_COMPONENT24,
+                          tileW, stripH);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rb[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rb[1]);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        printf("FBO incompleto para o poster\n");
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(2, rb);
+        posterPngClose(out);
+        return false;
+    }
+
+    double t0 = nowMs();
+    std::vector<unsigned char> strip((size_t)width * stripH * 3);
+    float top = sceneNear * tanf(30.0f * (float)M_PI / 180.0f);  // mesma projeção da vista geral (60 graus)
+    float right = top * width / height;
+    renderScale = (float)height / winHeight;
+    buildFrameScene(0, width, height);                         // só a vista geral, montada uma vez
+    updateShadowMap(frameScene.bodies, frameScene.bodyCount);
+    updateBelts();
+    bool hdr = hdrActive();                                    // em HDR: ladrilho em float + tonemapping
+    if (hdr) bindHdrTarget(tileW, stripH);
+    beginDepthState();
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, width);                  // ladrilhos lado a lado na faixa
+
+    bool ok = true;
+    for (int rowTop = height; ok && rowTop > 0; rowTop -= stripH) {  // PNG vai de cima para baixo
+        int y0 = std::max(0, rowTop - stripH), th = rowTop - y0;
+        for (int x0 = 0; x0 < width; x0 += tileW) {
+            int tw = std::min(tileW, width - x0);
+            glBindFramebuffer(GL_FRAMEBUFFER, hdr ? hdrTarget.fbo : fbo);
+            glViewport(0, 0, tw, th);
+            setFrustum(-right + 2.0f * right * x0 / width, -right + 2.0f * right * (x0 + tw) / width,
+                       -top + 2.0f * top * y0 / height, -top + 2.0f * top * (y0 + th) / height);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            submitView(frameScene, 0);
+            if (hdr) tonemapTo(fbo, tw, th, 0.0f);             // sem bloom: marcaria as emendas
+            glReadPixels(0, 0, tw, th, GL_RGB, GL_UNSIGNED_BYTE, &strip[(size_t)x0 * 3]);
+        }
+        ok = posterPngRows(out, strip.data(), th, (size_t)width * 3);
+    }
+    endDepthState();
+    ok = ok && posterPngEnd(out);
+    posterPngClose(out);
+
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(2, rb);
+    renderScale = 1.0f;
+    reshape(winWidth, winHeight);                              // volta à projeção da janela
+    if (!ok) { printf("Erro ao gravar PNG: %s\n", path); return false; }
+    printf("Poster %dx%d salvo em %s (%.1f s, faixas de %d linhas = %.1f MB)\n", width, height, path,
+           (nowMs() - t0) / 1000.0, stripH, strip.size() / (1024.0 * 1024.0));
+    return true;
+}
+
+// Tecla 'P': pôster com 4x a resolução da janela
+void savePoster() {
+    char path[64];
+    snprintf(path, sizeof(path), "poster_%ld.png", (long)time(NULL));
+    renderPoster(winWidth * 4, winHeight * 4, path);
+}
@@ -0,0 +1,64 @@
+// Renderização em OpenGL: shader da cena, modos de depth, vistas por quadro,
+// desenho dos corpos e das órbitas e captura em alta resolução (pôster)
+#ifndef SOLAR_RENDER_H
+#define SOLAR_RENDER_H
+
+#include "common.h"
+#include "camera.h"
+
+// Profundidade e escala. A escala comprimida original (Netuno a 72 unidades)
+// cabe no depth buffer padrão (0.5..300); com --true-scale os tamanhos e
+// distâncias são os reais (1 unidade = 1000 km) e é preciso reversed-Z com
+// depth em float (ou depth logarítmico, quando não há glClipControl).
+enum DepthMode { DEPTH_STANDARD = 0, DEPTH_REVERSED, DEPTH_LOG, DEPTH_MODES };
+
+extern const char* depthModeNames[DEPTH_MODES];
+extern int depthMode;                           // --depth=padrao|reversed-z|log (-1 = automático)
+extern float sceneNear, sceneFar;
+extern float lightLinearAtt, lightQuadraticAtt; // atenuação da luz do Sol
+extern float renderScale;                       // escala de pontos/linhas (> 1 nas capturas em alta resolução)
+
+bool hasExtension(const char* name);
+
+extern unsigned bodiesVisible; // corpos visíveis na vista principal (buildFrameScene)
+extern unsigned bodiesSoon;    // corpos visíveis na pose prevista da câmera
+
+void initLighting();
+
+extern GLuint sceneProgram;
+extern bool sceneProgramActive;
+
+void setLighting(bool on);
+void drawRing(float innerRadius, float outerRadius);
+void initOrbits();
+
+struct View {
+    int x, y, w, h;               // retângulo na janela/alvo (pixels)
+    double eye[3], center[3];     // em double: a cena é enviada relativa ao olho
+    float up[3];
+    float fovy;
+    int follow;                   // corpo acompanhado (-1 = vista geral)
+};
+
+extern int viewLayout;
+
+const int VIEW_LAYOUTS = 3;
+
+void frustumPlanes(const Mat4& vp, float planes[6][4]);
+bool sphereInFrustum(const float planes[6][4], const float c[3], float r);
+void buildFrameScene(int layout, int width, int height);
+GLuint linkProgram(const char* vertexSrc, const char* fragmentSrc, const char* const* feedback = NULL, int feedbackCount = 0);
+bool initSceneProgram();
+int glVersion();
+void initDepthMode();
+void setPerspective(float fovy, float aspect);
+void renderSceneGL();
+void presentSoftwareFrame();
+
+extern int posterWidth, posterHeight; // --poster=WxH
+extern const char* posterPath;        // --poster-out=arquivo.png
+
+bool renderPoster(int width, int height, const char* path);
+void savePoster();
+
+#endif
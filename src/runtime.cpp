@@ -0,0 +1,464 @@
+#include "runtime.h"
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <execinfo.h>
+#include <dlfcn.h>
+
+#include "render.h"
+
+// Relógio monotônico em milissegundos (medição de tempos de carga)
+double nowMs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1.0e6;
+}
+
+const int MAX_TRACE_THREADS = 16;
+
+// Publicado com release depois de o anel estar pronto: flushTrace lê de outra thread
+std::atomic<TraceRing*> traceRings[MAX_TRACE_THREADS];
+std::atomic<int> numTraceRings{0};
+thread_local TraceRing* traceLocalRing = NULL;
+
+TraceRing* traceThreadRing() {
+    if (!traceLocalRing) {
+        int slot = numTraceRings.load();
+        if (slot >= MAX_TRACE_THREADS) return NULL;
+        TraceRing* ring = new TraceRing();            // uma vez por thread
+        ring->tid = syscall(SYS_gettid);
+        slot = numTraceRings.fetch_add(1);
+        if (slot >= MAX_TRACE_THREADS) { delete ring; return NULL; }
+        traceRings[slot].store(ring, std::memory_order_release);
+        traceLocalRing = ring;
+    }
+    return traceLocalRing;
+}
+
+void traceEmitTo(TraceRing* ring, const char* name, double begin, double end) {
+    uint64_t h = ring->head.load(std::memory_order_relaxed);
+    ring->events[h % TRACE_RING_SIZE] = {name, begin, end - begin};
+    ring->head.store(h + 1, std::memory_order_release);
+}
+
+void traceEmit(const char* name, double begin, double end) {
+    TraceRing* ring = traceThreadRing();
+    if (ring) traceEmitTo(ring, name, begin, end);
+}
+
+const char* gpuPassNames[GPU_PASSES] = {"GPU: sombras", "GPU: cinturoes (Kepler)", "GPU: cena", "GPU: bloom (descida)",
+                                        "GPU: bloom (subida)", "GPU: tonemapping"};
+const long GPU_TRACE_TID    = 1000000000;     // tid fictício da trilha da GPU (acima de qualquer pid)
+
+GpuTimers gpuTimers;
+
+void initGpuTimers() {
+    if (!hasExtension("GL_ARB_timer_query")) return;
+    GpuTimers& gt = gpuTimers;
+    glGenQueries(GPU_TIMER_FRAMES * GPU_PASSES, &gt.queries[0][0]);
+    for (int f = 0; f < GPU_TIMER_FRAMES; ++f)
+        for (int p = 0; p < GPU_PASSES; ++p) gt.issued[f][p] = -1.0;
+    for (int p = 0; p < GPU_PASSES; ++p) { gt.totalMs[p] = 0.0; gt.samples[p] = 0; }
+    int slot = numTraceRings.fetch_add(1);
+    if (slot < MAX_TRACE_THREADS) {
+        gt.ring = new TraceRing();
+        gt.ring->tid = GPU_TRACE_TID;
+        traceRings[slot].store(gt.ring, std::memory_order_release);
+    }
+    gt.enabled = true;
+}
+
+// Início de quadro: colhe as medições do slot mais antigo e o reutiliza
+void gpuTimersNewFrame() {
+    GpuTimers& gt = gpuTimers;
+    if (!gt.enabled) return;
+    gt.frame = (gt.frame + 1) % GPU_TIMER_FRAMES;
+    for (int p = 0; p < GPU_PASSES; ++p) {
+        if (gt.issued[gt.frame][p] < 0) continue;
+        GLuint64 ns;
+        glGetQueryObjectui64v(gt.queries[gt.frame][p], GL_QUERY_RESULT, &ns);   // pronto há quadros
+        double ms = ns / 1.0e6;
+        double issued = gt.issued[gt.frame][p];
+        gt.issued[gt.frame][p] = -1.0;
+        if (ms > nowMs() - issued) continue;      // maior que o tempo desde o envio: leitura inválida do driver
+        gt.totalMs[p] += ms;
+        gt.samples[p]++;
+        if (gt.ring) traceEmitTo(gt.ring, gpuPassNames[p], issued, issued + ms);
+    }
+}
+
+void gpuTimerBegin(int pass) {
+    GpuTimers& gt = gpuTimers;
+    if (!gt.enabled || gt.active >= 0) return;     // só uma medição GL_TIME_ELAPSED por vez
+    glBeginQuery(GL_TIME_ELAPSED, gt.queries[gt.frame][pass]);
+    gt.issued[gt.frame][pass] = nowMs();
+    gt.active = pass;
+}
+
+void gpuTimerEnd() {
+    if (gpuTimers.active < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuTimers.active = -1;
+}
+
+// ---------------------------------------------------------------------------
+// Memória. Dados temporários de um quadro (instâncias, descarte, listas de
+// desenho) vêm de uma arena linear zerada no começo de display(): alocar é
+// avançar um ponteiro e nada é liberado um a um. Se um quadro passar da
+// capacidade, o excedente vem do heap e a arena cresce no reset seguinte
+// (fora do caminho quente). Nós de vida longa vêm de um pool com lista livre.
+// heapAllocs conta as idas ao heap de cada um: em regime estável não muda.
+const size_t FRAME_ARENA_INITIAL = 256u << 10;
+
+FrameArena frameArena;
+
+void* arenaAlloc(size_t bytes, size_t align) {
+    FrameArena& a = frameArena;
+    size_t start = (a.used + align - 1) & ~(align - 1);
+    if (start + bytes <= a.capacity) {
+        a.used = start + bytes;
+        a.peak = std::max(a.peak, a.used);
+        return a.base + start;
+    }
+    // não cabe: heap até o próximo reset (que cresce a arena)
+    a.overflowBytes += bytes + align;
+    a.heapAllocs++;
+    if (a.overflowCount == FRAME_ARENA_OVERFLOWS) {
+        printf("Erro: arena do quadro sem espaco (%zu bytes)\n", a.overflowBytes);
+        exit(1);
+    }
+    void* p = aligned_alloc(align, (bytes + align - 1) & ~(align - 1));
+    a.overflow[a.overflowCount++] = p;
+    return p;
+}
+
+// Começo do quadro: tudo o que veio da arena no quadro anterior deixa de valer
+void arenaReset() {
+    FrameArena& a = frameArena;
+    for (int i = 0; i < a.overflowCount; ++i) free(a.overflow[i]);
+    size_t needed = std::max(a.capacity, a.used + a.overflowBytes);
+    if (!a.base || needed > a.capacity) {
+        size_t capacity = (std::max(FRAME_ARENA_INITIAL, needed + needed / 2) + 63) & ~size_t(63);   // aligned_alloc: múltiplo de 64
+        free(a.base);
+        a.base = (unsigned char*)aligned_alloc(64, capacity);
+        a.capacity = capacity;
+        a.heapAllocs++;
+    }
+    a.used = 0;
+    a.overflowCount = 0;
+    a.overflowBytes = 0;
+    a.frames++;
+}
+
+// ---------------------------------------------------------------------------
+// Rastreamento de alocações: com SOLAR_ALLOC_HOOK (alvo solar-check, Debug
+// ou -DSOLAR_ALLOC_HOOK=ON), malloc/calloc/realloc e as variantes alinhadas
+// (e, por eles, o operator new) são interceptados e repassados ao alocador da
+// glibc. Desligado custa uma leitura atômica; ligado (--check-allocs), conta
+// cada alocação e agrupa por local de chamada (os primeiros quadros da pilha),
+// numa tabela fixa: o próprio gancho não pode alocar. Sem a definição, o
+// binário usa o malloc da glibc direto e o --check-allocs se recusa a rodar.
+AllocTracker allocTracker;
+
+#ifdef SOLAR_ALLOC_HOOK
+const bool allocHookCompiled = true;
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* __libc_memalign(size_t, size_t);
+extern "C" void* __libc_valloc(size_t);
+extern "C" void* __libc_pvalloc(size_t);
+
+thread_local bool inAllocHook = false;      // backtrace() pode alocar na primeira chamada
+
+// Bibliotecas do driver de GL (GLVND, Mesa, NVIDIA). A libGLU não está aqui:
+// um gluNewQuadric por quadro é do programa.
+bool isGlDriverModule(const char* path) {
+    static const char* const prefixes[] = {"libGL.", "libGLX", "libGLdispatch", "libEGL", "libOpenGL", "libglapi",
+                                           "libgallium", "libLLVM", "libdrm", "libnvidia"};
+    const char* name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+    for (const char* p : prefixes)
+        if (strncmp(name, p, strlen(p)) == 0) return true;
+    return strstr(name, "_dri") != NULL;
+}
+
+// Saindo do malloc para fora: a alocação é do programa se a pilha chega ao
+// executável antes de passar pelo driver (new, vector e gluNewQuadric chamados
+// daqui contam; o que o driver aloca dentro de um glDraw*, ou nas threads
+// dele, não)
+bool allocFromOwnCode(void* const* frames, int depth) {
+    Dl_info self, info;
+    if (!dladdr((void*)&allocFromOwnCode, &self)) return true;
+    for (int i = 0; i < depth; ++i) {
+        if (!dladdr(frames[i], &info)) continue;
+        if (info.dli_fbase == self.dli_fbase) return true;
+        if (info.dli_fname && isGlDriverModule(info.dli_fname)) return false;
+    }
+    return false;
+}
+
+__attribute__((noinline)) void allocRecord(size_t bytes) {
+    if (!allocTracker.enabled.load(std::memory_order_relaxed) || inAllocHook) return;
+    inAllocHook = true;
+    void* frames[ALLOC_SCAN_DEPTH + 2];
+    bool ownOnly = allocTracker.ownCodeOnly.load(std::memory_order_relaxed);
+    int depth = backtrace(frames, (ownOnly ? ALLOC_SCAN_DEPTH : ALLOC_SITE_DEPTH) + 2) - 2;   // pula allocRecord e o malloc
+    if (ownOnly && !allocFromOwnCode(frames + 2, depth)) {
+        inAllocHook = false;
+        return;
+    }
+    allocTracker.count.fetch_add(1, std::memory_order_relaxed);
+    depth = std::min(depth, ALLOC_SITE_DEPTH);
+    if (depth > 0) {
+        uintptr_t h = 0;
+        for (int i = 0; i < depth; ++i) h = (h ^ (uintptr_t)frames[i + 2]) * 0x100000001B3ULL;
+        while (allocTracker.lock.test_and_set(std::memory_order_acquire)) {}
+        for (int probe = 0; probe < ALLOC_SITES; ++probe) {
+            AllocSite& s = allocTracker.sites[(h + probe) & (ALLOC_SITES - 1)];
+            if (s.depth == 0) {
+                memcpy(s.frames, frames + 2, depth * sizeof(void*));
+                s.depth = depth;
+                allocTracker.siteCount++;
+            } else if (s.depth != depth || memcmp(s.frames, frames + 2, depth * sizeof(void*)) != 0) {
+                continue;
+            }
+            s.count++;
+            s.bytes += bytes;
+            break;
+        }
+        allocTracker.lock.clear(std::memory_order_release);
+    }
+    inAllocHook = false;
+}
+
+extern "C" void* malloc(size_t n) {
+    allocRecord(n);
+    return __libc_malloc(n);
+}
+
+extern "C" void* calloc(size_t n, size_t size) {
+    allocRecord(n * size);
+    return __libc_calloc(n, size);
+}
+
+extern "C" void* realloc(void* p, size_t n) {
+    allocRecord(n);
+    return __libc_realloc(p, n);
+}
+
+extern "C" void* aligned_alloc(size_t align, size_t n) {
+    allocRecord(n);
+    return __libc_memalign(align, n);
+}
+
+extern "C" void* memalign(size_t align, size_t n) {
+    allocRecord(n);
+    return __libc_memalign(align, n);
+}
+
+extern "C" int posix_memalign(void** out, size_t align, size_t n) {
+    if (align < sizeof(void*) || (align & (align - 1)) != 0) return EINVAL;
+    allocRecord(n);
+    void* p = __libc_memalign(align, n);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+extern "C" void* valloc(size_t n) {
+    allocRecord(n);
+    return __libc_valloc(n);
+}
+
+extern "C" void* pvalloc(size_t n) {
+    allocRecord(n);
+    return __libc_pvalloc(n);
+}
+#else
+const bool allocHookCompiled = false;
+#endif
+
+// Locais com mais alocações, com a pilha de cada um (endereços: use
+// addr2line -f -C -e ./solar para ver funções e linhas)
+void printAllocSites(int maxSites) {
+    std::vector<AllocSite*> order;
+    for (int i = 0; i < ALLOC_SITES; ++i)
+        if (allocTracker.sites[i].depth) order.push_back(&allocTracker.sites[i]);
+    std::sort(order.begin(), order.end(), [](const AllocSite* a, const AllocSite* b) { return a->count > b->count; });
+    for (int i = 0; i < (int)order.size() && i < maxSites; ++i) {
+        printf("  %lu alocacoes, %zu bytes:\n", order[i]->count, order[i]->bytes);
+        fflush(stdout);
+        backtrace_symbols_fd(order[i]->frames, order[i]->depth, 1);
+    }
+}
+
+// Rastreamento da inicialização: cada fase com tempos monotônicos, do início
+// do main() até o primeiro quadro (e até as texturas no modo --fast-start)
+struct StartupPhase {
+    const char* name;
+    double begin, end;           // ms desde o início do main()
+};
+
+const int MAX_STARTUP_PHASES = 32;
+StartupPhase startupPhases[MAX_STARTUP_PHASES];
+int numStartupPhases = 0;
+double startupStart = 0.0;
+const char* startupTracePath = NULL;
+
+void startupRecord(const char* name, double begin, double end) {
+    if (numStartupPhases < MAX_STARTUP_PHASES)
+        startupPhases[numStartupPhases++] = {name, begin - startupStart, end - startupStart};
+}
+
+// Encerra a fase atual e abre a próxima (name == NULL só encerra)
+void startupPhase(const char* name) {
+    double now = nowMs();
+    if (numStartupPhases > 0 && startupPhases[numStartupPhases - 1].end < 0)
+        startupPhases[numStartupPhases - 1].end = now - startupStart;
+    if (name) startupRecord(name, now, startupStart - 1.0);   // end < 0 = fase aberta
+}
+
+void printStartupReport() {
+    printf("Inicializacao:\n");
+    for (int i = 0; i < numStartupPhases; ++i)
+        printf("  %-28s %8.1f ms  (em %.1f ms)\n", startupPhases[i].name,
+               startupPhases[i].end - startupPhases[i].begin, startupPhases[i].end);
+}
+
+void writeStartupTrace(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) { printf("Erro ao criar %s\n", path); return; }
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (int i = 0; i < numStartupPhases; ++i)
+        fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                   "\"ts\":%.0f,\"dur\":%.0f}\n", i ? "," : "", startupPhases[i].name,
+                startupPhases[i].begin * 1000.0, (startupPhases[i].end - startupPhases[i].begin) * 1000.0);
+    fprintf(f, "]}\n");
+    fclose(f);
+    printf("Trace da inicializacao salvo em %s\n", path);
+}
+
+// Relatório final: no primeiro quadro, ou quando as texturas adiadas chegarem
+void finishStartupTrace() {
+    printStartupReport();
+    if (startupTracePath) writeStartupTrace(startupTracePath);
+}
+
+// Grava os anéis de todas as threads (e as fases da inicialização) num JSON
+// do Chrome trace. Leitura sem travas: copia o anel e descarta o que a thread
+// dona possa ter sobrescrito durante a cópia.
+void flushTrace() {
+    char path[64];
+    snprintf(path, sizeof(path), "trace_%ld.json", (long)time(NULL));
+    FILE* f = fopen(path, "w");
+    if (!f) { printf("Erro ao criar %s\n", path); return; }
+
+    long pid = getpid();
+    fprintf(f, "{\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"args\":{\"name\":\"Sistema Solar\"}}\n", pid);
+    if (gpuTimers.ring)
+        fprintf(f, ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"name\":\"GPU\"}}\n",
+                pid, GPU_TRACE_TID);
+    for (int i = 0; i < numStartupPhases; ++i)
+        if (startupPhases[i].end >= 0)
+            fprintf(f, ",{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%ld,"
+                       "\"ts\":%.1f,\"dur\":%.1f}\n", startupPhases[i].name, pid, pid,
+                    startupPhases[i].begin * 1000.0, (startupPhases[i].end - startupPhases[i].begin) * 1000.0);
+
+    std::vector<TraceEvent> copy(TRACE_RING_SIZE);
+    size_t written = 0;
+    int rings = numTraceRings.load() < MAX_TRACE_THREADS ? numTraceRings.load() : MAX_TRACE_THREADS;
+    for (int r = 0; r < rings; ++r) {
+        TraceRing* ring = traceRings[r].load(std::memory_order_acquire);
+        if (!ring) continue;
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > (uint64_t)TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        for (uint64_t e = first; e < head; ++e) copy[e - first] = ring->events[e % TRACE_RING_SIZE];
+        uint64_t after = ring->head.load(std::memory_order_acquire);
+        // A escritora pode já estar gravando o evento 'after' (ainda não
+        // publicado), que ocupa a posição de after - TRACE_RING_SIZE
+        uint64_t valid = after + 1 > (uint64_t)TRACE_RING_SIZE ? after + 1 - TRACE_RING_SIZE : 0;
+        for (uint64_t e = (valid > first ? valid : first); e < head; ++e) {   // ignora os sobrescritos
+            const TraceEvent& ev = copy[e - first];
+            fprintf(f, ",{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%ld,"
+                       "\"ts\":%.1f,\"dur\":%.1f}\n", ev.name, pid, ring->tid,
+                    (ev.begin - startupStart) * 1000.0, ev.dur * 1000.0);
+            ++written;
+        }
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+    printf("Trace salvo em %s (%zu eventos)\n", path, written);
+}
+
+// ---------------------------------------------------------------------------
+// Pool de threads: parallelFor(n, fn, ctx) chama fn(ctx, i) para i em [0, n),
+// distribuindo os índices entre as threads (a thread chamadora também trabalha).
+ThreadPool pool;
+
+// Cada tarefa é reservada com CAS num bilhete (geração << 32 | índice): uma
+// thread ainda saindo do lote anterior vê a geração mudar e não reserva nem
+// conta tarefas do lote novo
+void poolRunTasks(unsigned long generation, void (*fn)(void*, int), void* ctx, int count) {
+    uint64_t ticket = pool.next.load(std::memory_order_acquire);
+    for (;;) {
+        if ((ticket >> 32) != (generation & 0xFFFFFFFFu) || (int)(uint32_t)ticket >= count) break;
+        if (!pool.next.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel)) continue;
+        fn(ctx, (int)(uint32_t)ticket);
+        if (pool.done.fetch_add(1) + 1 == count) {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.finished.notify_all();
+        }
+        ticket = pool.next.load(std::memory_order_acquire);
+    }
+}
+
+void poolWorker() {
+    unsigned long seen = 0;
+    for (;;) {
+        void (*fn)(void*, int);
+        void* ctx;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.wake.wait(lock, [&] { return pool.generation != seen; });
+            seen = pool.generation;
+            fn = pool.fn;
+            ctx = pool.ctx;
+            count = pool.count;
+        }
+        poolRunTasks(seen, fn, ctx, count);
+    }
+}
+
+int poolThreads() {
+    return (int)pool.workers.size() + 1;
+}
+
+void startThreadPool() {
+    if (!pool.workers.empty()) return;
+    unsigned n = std::thread::hardware_concurrency();
+    for (unsigned i = 1; i < n && i < 32; ++i)
+        pool.workers.push_back(std::thread(poolWorker));
+    for (size_t i = 0; i < pool.workers.size(); ++i) pool.workers[i].detach();
+}
+
+void parallelFor(int count, void (*fn)(void*, int), void* ctx) {
+    if (count <= 0) return;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.fn = fn;
+        pool.ctx = ctx;
+        pool.count = count;
+        pool.done.store(0, std::memory_order_relaxed);
+        pool.generation++;
+        pool.next.store((uint64_t)(pool.generation & 0xFFFFFFFFu) << 32, std::memory_order_release);   // publica por último
+    }
+    pool.wake.notify_all();
+    poolRunTasks(pool.generation, fn, ctx, count);
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.finished.wait(lock, [&] { return pool.done.load() >= count; });
+}
@@ -0,0 +1,188 @@
+// Infraestrutura: relógio, trace por thread, tempos de GPU, arena por quadro,
+// rastreamento de alocações, fases da inicialização e pool de threads
+#ifndef SOLAR_RUNTIME_H
+#define SOLAR_RUNTIME_H
+
+#include "common.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <new>
+
+double nowMs();                 // relógio monotônico em milissegundos
+
+// Rastreamento contínuo (Chrome trace / Perfetto): cada thread escreve seus
+// eventos num anel próprio, sem travas; a thread principal lê os anéis e grava
+// o JSON sob demanda (tecla 'T').
+struct TraceEvent {
+    const char* name;        // literal estático
+    double begin, dur;       // ms (relógio monotônico)
+};
+
+const int TRACE_RING_SIZE   = 1 << 16;    // eventos guardados por thread (os mais antigos são sobrescritos)
+
+struct TraceRing {
+    std::atomic<uint64_t> head{0};        // total de eventos já escritos (só a dona escreve)
+    long tid;
+    TraceEvent events[TRACE_RING_SIZE];
+};
+
+void traceEmit(const char* name, double begin, double end);
+
+// Evento com escopo: mede do construtor ao destrutor
+struct TraceScope {
+    const char* name;
+    double begin;
+    explicit TraceScope(const char* n) : name(n), begin(nowMs()) {}
+    ~TraceScope() { traceEmit(name, begin, nowMs()); }
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+// Tempo de GPU por passe (GL_TIME_ELAPSED). Cada resultado é lido
+// GPU_TIMER_FRAMES quadros depois, quando já está pronto (sem travar a CPU),
+// e vai para o trace numa trilha própria ("GPU", a partir do instante em que
+// o passe foi enviado) e para o resumo do --bench.
+enum GpuPass { GPU_PASS_SHADOWS = 0, GPU_PASS_BELTS, GPU_PASS_SCENE, GPU_PASS_BLOOM_DOWN, GPU_PASS_BLOOM_UP,
+               GPU_PASS_TONEMAP, GPU_PASSES };
+
+extern const char* gpuPassNames[GPU_PASSES];
+
+const int  GPU_TIMER_FRAMES = 4;
+
+struct GpuTimers {
+    bool enabled = false;
+    GLuint queries[GPU_TIMER_FRAMES][GPU_PASSES];
+    double issued[GPU_TIMER_FRAMES][GPU_PASSES];   // envio na CPU (ms); < 0 = sem medição pendente
+    int frame = 0, active = -1;
+    double totalMs[GPU_PASSES];
+    long samples[GPU_PASSES];
+    TraceRing* ring = NULL;                        // só a thread principal escreve
+};
+
+extern GpuTimers gpuTimers;
+
+void initGpuTimers();
+void gpuTimersNewFrame();
+void gpuTimerBegin(int pass);
+void gpuTimerEnd();
+
+// Memória do quadro: arena linear zerada no começo de display() (arenaReset)
+const int    FRAME_ARENA_OVERFLOWS = 64;   // excedentes de um quadro antes de crescer
+
+struct FrameArena {
+    unsigned char* base = NULL;
+    size_t capacity = 0, used = 0, peak = 0;
+    void* overflow[FRAME_ARENA_OVERFLOWS];  // blocos do heap do quadro atual
+    int overflowCount = 0;
+    size_t overflowBytes = 0;
+    unsigned long heapAllocs = 0;
+    unsigned long frames = 0;
+};
+
+extern FrameArena frameArena;
+
+void* arenaAlloc(size_t bytes, size_t align = 16);
+
+template<class T> T* arenaArray(size_t n) {
+    return (T*)arenaAlloc(sizeof(T) * n, alignof(T) < 16 ? 16 : alignof(T));
+}
+
+void arenaReset();
+
+// Pool de nós de vida longa: blocos de CHUNK nós (os endereços não mudam) e
+// lista livre intrusiva; só vai ao heap quando abre um bloco novo.
+template<class T, int CHUNK = 64> struct NodePool {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    std::vector<Slot*> chunks;
+    Slot* freeList = NULL;
+    int live = 0;
+    unsigned long heapAllocs = 0;
+
+    T* create() {
+        if (!freeList) {
+            Slot* chunk = (Slot*)malloc(sizeof(Slot) * CHUNK);
+            chunks.push_back(chunk);
+            heapAllocs++;
+            for (int i = CHUNK - 1; i >= 0; --i) {
+                chunk[i].next = freeList;
+                freeList = &chunk[i];
+            }
+        }
+        Slot* s = freeList;
+        freeList = s->next;
+        live++;
+        return new (s->storage) T();
+    }
+
+    void destroy(T* p) {
+        p->~T();
+        Slot* s = (Slot*)p;
+        s->next = freeList;
+        freeList = s;
+        live--;
+    }
+};
+
+// Rastreamento de alocações (malloc e cia. interceptados; --check-allocs)
+const int ALLOC_SITE_DEPTH = 8;
+const int ALLOC_SCAN_DEPTH = 48;            // pilha examinada para achar o código do programa (ownCodeOnly)
+const int ALLOC_SITES = 1024;               // potência de 2
+
+struct AllocSite {
+    void* frames[ALLOC_SITE_DEPTH];
+    int depth;
+    unsigned long count;
+    size_t bytes;
+};
+
+struct AllocTracker {
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> ownCodeOnly{false};   // ignora o que o driver de GL aloca por conta própria
+    std::atomic<unsigned long> count{0};
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    AllocSite sites[ALLOC_SITES];
+    int siteCount = 0;
+};
+
+extern AllocTracker allocTracker;
+extern const bool allocHookCompiled;        // malloc e cia. interceptados neste binário (SOLAR_ALLOC_HOOK)
+
+void printAllocSites(int maxSites);
+
+// Fases da inicialização (relatório e --startup-trace) e gravação do trace
+extern double startupStart;
+extern const char* startupTracePath; // --startup-trace=arquivo.json (formato Chrome trace)
+
+void startupRecord(const char* name, double begin, double end);
+void startupPhase(const char* name);
+void printStartupReport();
+void finishStartupTrace();
+void flushTrace();
+
+// Pool de threads: parallelFor(n, fn, ctx) chama fn(ctx, i) para i em [0, n)
+struct ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    void (*fn)(void*, int) = NULL;
+    void* ctx = NULL;
+    int count = 0;
+    std::atomic<uint64_t> next{0};    // bilhete: (geração << 32) | próximo índice
+    std::atomic<int> done{0};
+    unsigned long generation = 0;     // só muda sob o mutex
+};
+
+extern ThreadPool pool;
+
+int poolThreads();
+void startThreadPool();
+void parallelFor(int count, void (*fn)(void*, int), void* ctx);
+
+#endif
@@ -0,0 +1,165 @@
+#include "shadows.h"
+
+#include "camera.h"
+#include "render.h"
+#include "runtime.h"
+
+// ---------------------------------------------------------------------------
+// Sombras e eclipses: cube map com a distância de cada texel ao Sol (luz
+// pontual na origem, dividida por sceneFar para caber em [0, 1]), comparada
+// no shader da cena. Cada face só é redesenhada
+// quando um corpo dentro dela se moveu, entrou ou saiu; a lista de corpos que
+// projetam sombra é descartada por face com o frustum de 90 graus. Em escala
+// real um texel cobre milhares de km (mais que um planeta), então as sombras
+// ficam desligadas; o ray tracer continua calculando os eclipses exatos.
+const int SHADOW_SIZE = 1024;          // resolução de cada face
+
+ShadowMap shadowMap;
+bool useShadows = true;
+bool showShadows = true;
+
+// Faces na ordem GL_TEXTURE_CUBE_MAP_POSITIVE_X + i (convenção do cube map)
+const float cubeFaceDir[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+const float cubeFaceUp[6][3]  = {{0, -1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {0, -1, 0}, {0, -1, 0}};
+
+const char* shadowVertexShader =
+    "#version 120\n"
+    "uniform float shadowScale;\n"
+    "varying float dist;\n"
+    "void main() {\n"
+    "    vec4 eye = gl_ModelViewMatrix * gl_Vertex;\n"    // o Sol é o olho
+    "    dist = length(eye.xyz) * shadowScale;\n"
+    "    gl_Position = gl_ProjectionMatrix * eye;\n"
+    "}\n";
+
+const char* shadowFragmentShader =
+    "#version 120\n"
+    "varying float dist;\n"
+    "void main() { gl_FragColor = vec4(dist); }\n";
+
+bool shadowsActive() {
+    return shadowMap.ready && showShadows;
+}
+
+bool initShadows() {
+    if (!useShadows) return false;
+    if (trueScale) {
+        printf("Sombras desligadas na escala real (planetas menores que um texel do cube map)\n");
+        return false;
+    }
+    ShadowMap& sm = shadowMap;
+    if (glVersion() < 30 || !initSceneProgram() || !(sm.program = linkProgram(shadowVertexShader, shadowFragmentShader))) {
+        printf("Sem GLSL 1.20 / texturas em float: sombras desligadas\n");
+        return false;
+    }
+    glGenTextures(1, &sm.cube);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, sm.cube);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    for (int f = 0; f < 6; ++f)
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_R32F, SHADOW_SIZE, SHADOW_SIZE, 0, GL_RED, GL_FLOAT, NULL);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    glGenRenderbuffers(1, &sm.depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, sm.depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, SHADOW_SIZE, SHADOW_SIZE);
+    glGenFramebuffers(1, &sm.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, sm.fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sm.depth);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X, sm.cube, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        printf("FBO incompleto para as sombras\n");
+        return false;
+    }
+
+    sm.sphere = glGenLists(1);                      // esfera unitária dos corpos no passe de sombra
+    glNewList(sm.sphere, GL_COMPILE);
+    GLUquadric* quad = gluNewQuadric();
+    gluSphere(quad, 1.0, 32, 16);
+    gluDeleteQuadric(quad);
+    glEndList();
+    for (int f = 0; f < 6; ++f) sm.drawn[f] = false;
+    glUseProgram(sm.program);
+    glUniform1f(glGetUniformLocation(sm.program, "shadowScale"), 1.0f / sceneFar);
+    glUseProgram(sceneProgram);
+    glUniform1f(glGetUniformLocation(sceneProgram, "shadowScale"), 1.0f / sceneFar);
+    glUseProgram(0);
+    sm.ready = true;
+    printf("Sombras: cube map %dx%d (R32F)\n", SHADOW_SIZE, SHADOW_SIZE);
+    return true;
+}
+
+// Passe de sombra (antes das vistas): redesenha só as faces cujos corpos mudaram
+void updateShadowMap(const BodyInstance* bodies, int count) {
+    if (!shadowsActive()) return;
+    TRACE_SCOPE("sombras");
+    gpuTimerBegin(GPU_PASS_SHADOWS);
+    ShadowMap& sm = shadowMap;
+    GLint prevFbo, prevViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFbo);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    Mat4 proj = mat4Perspective(90.0f, 1.0f, sunRadius, sceneFar);   // nada projeta sombra dentro do Sol
+    const float zero[3] = {0, 0, 0};
+    bool bound = false;
+    sm.facesUpdated = 0;
+
+    for (int f = 0; f < 6; ++f) {
+        Mat4 view = mat4LookAt(zero, cubeFaceDir[f], cubeFaceUp[f]);
+        float planes[6][4];
+        frustumPlanes(mat4Mul(proj, view), planes);
+        unsigned mask = 0;
+        bool moved = false;
+        for (int b = 1; b < count; ++b) {           // o Sol é a luz, não projeta sombra
+            const BodyInstance& body = bodies[b];
+            float c[3] = {(float)(body.world[0] - bodies[0].world[0]), (float)(body.world[1] - bodies[0].world[1]),
+                          (float)(body.world[2] - bodies[0].world[2])};
+            if (!sphereInFrustum(planes, c, body.radius * (body.hasRing ? body.ring.outer : 1.0f))) continue;
+            mask |= 1u << b;
+            for (int k = 0; k < 3; ++k) moved |= sm.casterPos[f][b][k] != body.world[k];
+        }
+        if (sm.drawn[f] && mask == sm.casters[f] && !moved) continue;
+
+        if (!bound) {
+            glBindFramebuffer(GL_FRAMEBUFFER, sm.fbo);
+            glViewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
+            glUseProgram(sm.program);
+            glMatrixMode(GL_PROJECTION);
+            glLoadMatrixf(proj.m);
+            glMatrixMode(GL_MODELVIEW);
+            glClearColor(1, 0, 0, 0);                 // sem nada na frente: distância máxima
+            bound = true;
+        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, sm.cube, 0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glLoadMatrixf(view.m);
+        for (int b = 1; b < count; ++b) {
+            if (!(mask & (1u << b))) continue;
+            const BodyInstance& body = bodies[b];
+            glPushMatrix();
+            glTranslated(body.world[0] - bodies[0].world[0], body.world[1] - bodies[0].world[1],
+                         body.world[2] - bodies[0].world[2]);
+            if (body.hasRing) {                       // mesmo anel de drawPlanets
+                glRotatef(body.ring.tiltDeg, 1, 0, 0);
+                drawRing(body.radius * body.ring.inner, body.radius * body.ring.outer);
+            }
+            glScalef(body.radius, body.radius, body.radius);
+            glCallList(sm.sphere);
+            glPopMatrix();
+            for (int k = 0; k < 3; ++k) sm.casterPos[f][b][k] = body.world[k];
+        }
+        sm.casters[f] = mask;
+        sm.drawn[f] = true;
+        sm.facesUpdated++;
+    }
+    if (bound) {
+        glClearColor(0, 0, 0, 0);
+        glUseProgram(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, prevFbo);
+        glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    }
+    gpuTimerEnd();
+}
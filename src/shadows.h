@@ -0,0 +1,25 @@
+// Sombras e eclipses: cube map de distâncias ao Sol
+#ifndef SOLAR_SHADOWS_H
+#define SOLAR_SHADOWS_H
+
+#include "common.h"
+#include "bodies.h"
+
+struct ShadowMap {
+    bool ready;
+    GLuint cube, depth, fbo, program, sphere;
+    bool drawn[6];
+    unsigned casters[6];               // bits dos corpos desenhados em cada face
+    double casterPos[6][NUM_BODIES][3];         // posições desses corpos no último desenho
+    int facesUpdated;                  // faces redesenhadas no último quadro
+};
+
+extern ShadowMap shadowMap;
+extern bool useShadows;  // --no-shadows
+extern bool showShadows; // tecla 'S'
+
+bool shadowsActive();
+bool initShadows();
+void updateShadowMap(const BodyInstance* bodies, int count);
+
+#endif
@@ -0,0 +1,619 @@
+#include "software.h"
+
+#include <emmintrin.h>
+
+#include "app.h"
+#include "belts.h"
+#include "comets.h"
+#include "render.h"
+#include "runtime.h"
+#include "stars.h"
+#include "texture.h"
+
+// ---------------------------------------------------------------------------
+// Rasterizador em software (para nós sem GPU): a cena de display() é
+// transformada e iluminada por vértice na thread principal, os primitivos são
+// distribuídos em ladrilhos (tiles) de 64x64 e cada ladrilho é rasterizado por
+// uma thread do pool, com as funções de aresta avaliadas 4 pixels por vez (SSE).
+
+const int SW_TILE = 64;
+
+struct SwClipVertex {
+    float clip[4];
+    float color[3];
+    float uv[2];
+};
+
+enum SwPrimType { SW_TRI = 0, SW_LINE = 1, SW_POINT = 2, SW_PARTICLE = 3 };
+
+SwRenderer sw;
+bool softwareBackend = false;
+
+// Esfera unitária com os mesmos vértices/coordenadas do gluSphere(slices, stacks)
+SwMesh buildSphereMesh(int slices, int stacks) {
+    SwMesh mesh;
+    for (int i = 0; i <= stacks; ++i) {
+        float rho = (float)M_PI * i / stacks;
+        for (int j = 0; j <= slices; ++j) {
+            float theta = (j == slices) ? 0.0f : 2.0f * (float)M_PI * j / slices;
+            SwVertex v;
+            v.normal[0] = -sinf(theta) * sinf(rho);
+            v.normal[1] = cosf(theta) * sinf(rho);
+            v.normal[2] = cosf(rho);
+            for (int c = 0; c < 3; ++c) v.pos[c] = v.normal[c];
+            v.uv[0] = (float)j / slices;
+            v.uv[1] = 1.0f - (float)i / stacks;
+            mesh.verts.push_back(v);
+        }
+    }
+    for (int i = 0; i < stacks; ++i)
+        for (int j = 0; j < slices; ++j) {
+            unsigned a = i * (slices + 1) + j, b = a + slices + 1;
+            unsigned tri[6] = {a, b, a + 1, a + 1, b, b + 1};
+            mesh.indices.insert(mesh.indices.end(), tri, tri + 6);
+        }
+    return mesh;
+}
+
+// Anel de Saturno (o mesmo GL_QUAD_STRIP de drawRing, em triângulos)
+SwMesh buildRingMesh(float innerRadius, float outerRadius, int numSegments) {
+    SwMesh mesh;
+    for (int i = 0; i <= numSegments; ++i) {
+        float angle = 2.0f * (float)M_PI * i / numSegments;
+        SwVertex in = {{innerRadius * cosf(angle), 0, innerRadius * sinf(angle)}, {0, 1, 0}, {0, 0}};
+        SwVertex out = {{outerRadius * cosf(angle), 0, outerRadius * sinf(angle)}, {0, 1, 0}, {0, 0}};
+        mesh.verts.push_back(in);
+        mesh.verts.push_back(out);
+    }
+    for (int i = 0; i < numSegments; ++i) {
+        unsigned a = 2 * i;
+        unsigned tri[6] = {a, a + 1, a + 2, a + 2, a + 1, a + 3};
+        mesh.indices.insert(mesh.indices.end(), tri, tri + 6);
+    }
+    return mesh;
+}
+
+void swResize(int w, int h) {
+    if (sw.width == w && sw.height == h) return;
+    sw.width = w;
+    sw.height = h;
+    sw.tilesX = (w + SW_TILE - 1) / SW_TILE;
+    sw.tilesY = (h + SW_TILE - 1) / SW_TILE;
+    sw.color.assign((size_t)w * h, 0);
+    sw.depth.assign((size_t)w * h, 1.0f);
+    sw.binStart.assign(sw.tilesX * sw.tilesY + 1, 0);
+    sw.binCursor.assign(sw.tilesX * sw.tilesY, 0);
+}
+
+// Entradas de ladrilho reservadas além das partículas (triângulos, linhas, estrelas)
+const size_t SW_BIN_RESERVE = 1u << 18;
+
+void swInit() {
+    if (sw.sunMesh.verts.empty()) {
+        sw.sunMesh = buildSphereMesh(50, 50);
+        sw.planetMesh = buildSphereMesh(30, 30);
+    }
+    loadCpuTextures();
+    startThreadPool();
+    generateBelts();
+    // Cinturões e cometas têm tamanho limitado: reservar tudo de uma vez evita
+    // que o quadro aloque quando as caudas crescem
+    size_t particles = COMET_POOL + MAX_COMETS;
+    for (int k = 0; k < BELTS; ++k) particles += (size_t)(belts[k].count + BELT_BATCH - 1) / BELT_BATCH * BELT_BATCH;
+    sw.particles.reserve(particles);
+    sw.binEntries.reserve(particles + SW_BIN_RESERVE);
+    sw.binPrims.reserve(particles + SW_BIN_RESERVE);
+}
+
+void swBin(uint32_t prim, int minX, int minY, int maxX, int maxY) {
+    int tx0 = minX / SW_TILE, ty0 = minY / SW_TILE;
+    int tx1 = maxX / SW_TILE, ty1 = maxY / SW_TILE;
+    for (int ty = ty0; ty <= ty1; ++ty)
+        for (int tx = tx0; tx <= tx1; ++tx)
+            sw.binEntries.push_back((uint64_t)(ty * sw.tilesX + tx) << 32 | prim);
+}
+
+// Agrupa as entradas por ladrilho (ordenação por contagem, estável)
+void swSortBins() {
+    int tiles = sw.tilesX * sw.tilesY;
+    std::fill(sw.binStart.begin(), sw.binStart.end(), 0);
+    for (size_t i = 0; i < sw.binEntries.size(); ++i) sw.binStart[(sw.binEntries[i] >> 32) + 1]++;
+    for (int t = 0; t < tiles; ++t) {
+        sw.binStart[t + 1] += sw.binStart[t];
+        sw.binCursor[t] = sw.binStart[t];
+    }
+    sw.binPrims.resize(sw.binEntries.size());
+    for (size_t i = 0; i < sw.binEntries.size(); ++i)
+        sw.binPrims[sw.binCursor[sw.binEntries[i] >> 32]++] = (uint32_t)sw.binEntries[i];
+}
+
+// Projeta um triângulo já recortado (w > 0) para a tela e o distribui nos ladrilhos
+void swEmitTriangle(const SwClipVertex* v[3], int texture, bool cullBack) {
+    SwTriangle tri;
+    for (int i = 0; i < 3; ++i) {
+        float iw = 1.0f / v[i]->clip[3];
+        tri.x[i] = (v[i]->clip[0] * iw * 0.5f + 0.5f) * sw.width;
+        tri.y[i] = (v[i]->clip[1] * iw * 0.5f + 0.5f) * sw.height;
+        tri.z[i] = v[i]->clip[2] * iw * 0.5f + 0.5f;
+        tri.invW[i] = iw;
+        for (int c = 0; c < 3; ++c) tri.color[i][c] = v[i]->color[c] * iw;
+        tri.uv[i][0] = v[i]->uv[0] * iw;
+        tri.uv[i][1] = v[i]->uv[1] * iw;
+    }
+    float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+    if (area == 0.0f || (cullBack && area < 0.0f)) return;
+    if (area < 0.0f) {                      // orientação anti-horária para as funções de aresta
+        std::swap(tri.x[1], tri.x[2]); std::swap(tri.y[1], tri.y[2]);
+        std::swap(tri.z[1], tri.z[2]); std::swap(tri.invW[1], tri.invW[2]);
+        for (int c = 0; c < 3; ++c) std::swap(tri.color[1][c], tri.color[2][c]);
+        std::swap(tri.uv[1][0], tri.uv[2][0]); std::swap(tri.uv[1][1], tri.uv[2][1]);
+    }
+    float minX = std::min(tri.x[0], std::min(tri.x[1], tri.x[2]));
+    float maxX = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+    float minY = std::min(tri.y[0], std::min(tri.y[1], tri.y[2]));
+    float maxY = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+    tri.minX = std::max(0, (int)floorf(minX));
+    tri.minY = std::max(0, (int)floorf(minY));
+    tri.maxX = std::min(sw.width - 1, (int)ceilf(maxX));
+    tri.maxY = std::min(sw.height - 1, (int)ceilf(maxY));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+    tri.texture = texture;
+    sw.tris.push_back(tri);
+    swBin((SW_TRI << 30) | (uint32_t)(sw.tris.size() - 1), tri.minX, tri.minY, tri.maxX, tri.maxY);
+}
+
+SwClipVertex swLerp(const SwClipVertex& a, const SwClipVertex& b, float s) {
+    SwClipVertex r;
+    for (int i = 0; i < 4; ++i) r.clip[i] = a.clip[i] + (b.clip[i] - a.clip[i]) * s;
+    for (int i = 0; i < 3; ++i) r.color[i] = a.color[i] + (b.color[i] - a.color[i]) * s;
+    for (int i = 0; i < 2; ++i) r.uv[i] = a.uv[i] + (b.uv[i] - a.uv[i]) * s;
+    return r;
+}
+
+// Recorte no plano near (z >= -w); os demais planos ficam por conta do
+// recorte de bounding box na tela
+void swClipTriangle(const SwClipVertex& a, const SwClipVertex& b, const SwClipVertex& c, int texture, bool cullBack) {
+    const SwClipVertex* in[3] = {&a, &b, &c};
+    float d[3];
+    int inside = 0;
+    for (int i = 0; i < 3; ++i) {
+        d[i] = in[i]->clip[2] + in[i]->clip[3];
+        inside += d[i] >= 0.0f;
+    }
+    if (inside == 0) return;
+    if (inside == 3) { swEmitTriangle(in, texture, cullBack); return; }
+
+    SwClipVertex poly[4];
+    int n = 0;
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        if (d[i] >= 0.0f) poly[n++] = *in[i];
+        if ((d[i] >= 0.0f) != (d[j] >= 0.0f)) poly[n++] = swLerp(*in[i], *in[j], d[i] / (d[i] - d[j]));
+    }
+    for (int i = 1; i + 1 < n; ++i) {
+        const SwClipVertex* tri[3] = {&poly[0], &poly[i], &poly[i + 1]};
+        swEmitTriangle(tri, texture, cullBack);
+    }
+}
+
+// Iluminação por vértice equivalente ao GL_LIGHT0 de initLighting()
+// (ambiente e difusa vêm da cor atual via GL_COLOR_MATERIAL)
+void swLight(const float posEye[3], const float nEye[3], const float matColor[3],
+             const float emission[3], float out[3]) {
+    const float globalAmbient = 0.05f, matSpecular = 0.8f, shininess = 50.0f;
+    const Light& light = sunLight();
+
+    float L[3] = {sw.lightEye[0] - posEye[0], sw.lightEye[1] - posEye[1], sw.lightEye[2] - posEye[2]};
+    float dist = sqrtf(L[0]*L[0] + L[1]*L[1] + L[2]*L[2]);
+    float att = 1.0f / (1.0f + lightLinearAtt * dist + lightQuadraticAtt * dist * dist);
+    for (int i = 0; i < 3; ++i) L[i] /= dist;
+    float ndotl = nEye[0]*L[0] + nEye[1]*L[1] + nEye[2]*L[2];
+    float spec = 0.0f;
+    if (ndotl > 0.0f) {
+        float H[3] = {L[0], L[1], L[2] + 1.0f};   // observador no infinito (GL_LIGHT_MODEL_LOCAL_VIEWER falso)
+        float hl = sqrtf(H[0]*H[0] + H[1]*H[1] + H[2]*H[2]);
+        float ndoth = (nEye[0]*H[0] + nEye[1]*H[1] + nEye[2]*H[2]) / hl;
+        if (ndoth > 0.0f) spec = powf(ndoth, shininess);
+    } else {
+        ndotl = 0.0f;
+    }
+    for (int i = 0; i < 3; ++i) {
+        float c = emission[i] + globalAmbient * matColor[i]
+                + att * (light.ambient[i] * matColor[i] + light.diffuse[i] * ndotl * matColor[i]
+                         + light.specular[i] * matSpecular * spec);
+        out[i] = c > 1.0f ? 1.0f : c;
+    }
+}
+
+void swDrawMesh(const SwMesh& mesh, const Mat4& model, const float matColor[3], const float emission[3],
+                bool lit, int texture, bool cullBack, std::vector<SwClipVertex>& scratch) {
+    Mat4 modelView = mat4Mul(sw.view, model);
+    Mat4 mvp = mat4Mul(sw.proj, modelView);
+    scratch.resize(mesh.verts.size());
+    for (size_t i = 0; i < mesh.verts.size(); ++i) {
+        const SwVertex& v = mesh.verts[i];
+        float p[4] = {v.pos[0], v.pos[1], v.pos[2], 1.0f};
+        SwClipVertex& out = scratch[i];
+        mat4Apply(mvp, p, out.clip);
+        out.uv[0] = v.uv[0];
+        out.uv[1] = v.uv[1];
+        if (lit) {
+            float pe[4], ne[3];
+            mat4Apply(modelView, p, pe);
+            for (int r = 0; r < 3; ++r)
+                ne[r] = modelView.m[r] * v.normal[0] + modelView.m[4+r] * v.normal[1] + modelView.m[8+r] * v.normal[2];
+            float nl = sqrtf(ne[0]*ne[0] + ne[1]*ne[1] + ne[2]*ne[2]);   // GL_NORMALIZE
+            for (int r = 0; r < 3; ++r) ne[r] /= nl;
+            swLight(pe, ne, matColor, emission, out.color);
+        } else {
+            for (int c = 0; c < 3; ++c) out.color[c] = matColor[c];
+        }
+    }
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        swClipTriangle(scratch[mesh.indices[i]], scratch[mesh.indices[i + 1]], scratch[mesh.indices[i + 2]],
+                       texture, cullBack);
+}
+
+void swSubmitLine(const float a[3], const float b[3], const Mat4& vp, const float color[3]) {
+    float pa[4] = {a[0], a[1], a[2], 1.0f}, pb[4] = {b[0], b[1], b[2], 1.0f}, ca[4], cb[4];
+    mat4Apply(vp, pa, ca);
+    mat4Apply(vp, pb, cb);
+    float da = ca[2] + ca[3], db = cb[2] + cb[3];
+    if (da < 0 && db < 0) return;
+    if (da < 0 || db < 0) {                   // recorte no near
+        float s = da / (da - db);
+        float* out = da < 0 ? ca : cb;
+        for (int i = 0; i < 4; ++i) out[i] = ca[i] + (cb[i] - ca[i]) * s;
+    }
+    SwLine l;
+    l.x0 = (ca[0] / ca[3] * 0.5f + 0.5f) * sw.width;  l.y0 = (ca[1] / ca[3] * 0.5f + 0.5f) * sw.height;
+    l.x1 = (cb[0] / cb[3] * 0.5f + 0.5f) * sw.width;  l.y1 = (cb[1] / cb[3] * 0.5f + 0.5f) * sw.height;
+    l.z0 = ca[2] / ca[3] * 0.5f + 0.5f;
+    l.z1 = cb[2] / cb[3] * 0.5f + 0.5f;
+    for (int c = 0; c < 3; ++c) l.color[c] = color[c];
+    int minX = std::max(0, (int)floorf(std::min(l.x0, l.x1)));
+    int maxX = std::min(sw.width - 1, (int)ceilf(std::max(l.x0, l.x1)));
+    int minY = std::max(0, (int)floorf(std::min(l.y0, l.y1)));
+    int maxY = std::min(sw.height - 1, (int)ceilf(std::max(l.y0, l.y1)));
+    if (minX > maxX || minY > maxY) return;
+    sw.lines.push_back(l);
+    swBin((SW_LINE << 30) | (uint32_t)(sw.lines.size() - 1), minX, minY, maxX, maxY);
+}
+
+// Rasteriza um triângulo dentro do ladrilho [x0,x1]x[y0,y1]
+void swRasterTriangle(const SwTriangle& tri, int x0, int y0, int x1, int y1) {
+    int minX = std::max(x0, tri.minX), maxX = std::min(x1, tri.maxX);
+    int minY = std::max(y0, tri.minY), maxY = std::min(y1, tri.maxY);
+    if (minX > maxX || minY > maxY) return;
+
+    // Funções de aresta E_i(x,y) = A_i x + B_i y + C_i (aresta oposta ao vértice i)
+    float A[3], B[3], C[3];
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3, k = (i + 2) % 3;
+        A[i] = tri.y[j] - tri.y[k];
+        B[i] = tri.x[k] - tri.x[j];
+        C[i] = tri.x[j] * tri.y[k] - tri.x[k] * tri.y[j];
+    }
+    float invArea = 1.0f / (C[0] + C[1] + C[2]);
+    const CpuImage* tex = tri.texture >= 0 ? &cpuTextures[tri.texture] : NULL;
+
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 a0 = _mm_set1_ps(A[0]), a1 = _mm_set1_ps(A[1]), a2 = _mm_set1_ps(A[2]);
+    __m128 z0 = _mm_set1_ps(tri.z[0]), z1 = _mm_set1_ps(tri.z[1]), z2 = _mm_set1_ps(tri.z[2]);
+    __m128 ia = _mm_set1_ps(invArea);
+
+    for (int y = minY; y <= maxY; ++y) {
+        float py = y + 0.5f;
+        float* depthRow = &sw.depth[(size_t)y * sw.width];
+        uint32_t* colorRow = &sw.color[(size_t)y * sw.width];
+        for (int x = minX; x <= maxX; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), _mm_set1_ps(B[0] * py + C[0]));
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), _mm_set1_ps(B[1] * py + C[1]));
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), _mm_set1_ps(B[2] * py + C[2]));
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                       _mm_cmpge_ps(e2, zero));
+            int mask = _mm_movemask_ps(inside);
+            if (!mask) continue;
+
+            __m128 w0 = _mm_mul_ps(e0, ia), w1 = _mm_mul_ps(e1, ia), w2 = _mm_mul_ps(e2, ia);
+            __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, z0), _mm_mul_ps(w1, z1)), _mm_mul_ps(w2, z2));
+            float zl[4], b0[4], b1[4], b2[4];
+            _mm_storeu_ps(zl, z);
+            _mm_storeu_ps(b0, w0);
+            _mm_storeu_ps(b1, w1);
+            _mm_storeu_ps(b2, w2);
+
+            for (int lane = 0; lane < 4; ++lane) {
+                int xx = x + lane;
+                if (!(mask & (1 << lane)) || xx > maxX) continue;
+                if (zl[lane] < 0.0f || zl[lane] >= depthRow[xx]) continue;   // teste de profundidade (GL_LESS)
+                depthRow[xx] = zl[lane];
+
+                // interpolação com correção de perspectiva
+                float iw = b0[lane] * tri.invW[0] + b1[lane] * tri.invW[1] + b2[lane] * tri.invW[2];
+                float w = 1.0f / iw;
+                float col[3];
+                for (int c = 0; c < 3; ++c)
+                    col[c] = (b0[lane] * tri.color[0][c] + b1[lane] * tri.color[1][c] + b2[lane] * tri.color[2][c]) * w;
+                if (tex) {
+                    float u = (b0[lane] * tri.uv[0][0] + b1[lane] * tri.uv[1][0] + b2[lane] * tri.uv[2][0]) * w;
+                    float v = (b0[lane] * tri.uv[0][1] + b1[lane] * tri.uv[1][1] + b2[lane] * tri.uv[2][1]) * w;
+                    float texel[3];
+                    sampleTexture(*tex, u, v, texel);
+                    for (int c = 0; c < 3; ++c) col[c] *= texel[c];        // GL_MODULATE
+                }
+                colorRow[xx] = swPack(col[0], col[1], col[2]);
+            }
+        }
+    }
+}
+
+void swRasterLine(const SwLine& l, int x0, int y0, int x1, int y1) {
+    float dx = l.x1 - l.x0, dy = l.y1 - l.y0;
+    int steps = (int)ceilf(std::max(fabsf(dx), fabsf(dy)));
+    if (steps < 1) steps = 1;
+    uint32_t c = swPack(l.color[0], l.color[1], l.color[2]);
+    for (int s = 0; s <= steps; ++s) {
+        float f = (float)s / steps;
+        int x = (int)(l.x0 + dx * f), y = (int)(l.y0 + dy * f);
+        if (x < x0 || x > x1 || y < y0 || y > y1) continue;
+        float z = l.z0 + (l.z1 - l.z0) * f;
+        size_t idx = (size_t)y * sw.width + x;
+        if (z < 0.0f || z >= sw.depth[idx]) continue;
+        sw.depth[idx] = z;
+        sw.color[idx] = c;
+    }
+}
+
+// Estrelas: pontos de 2x2 (glPointSize 1.5 arredondado), sem teste nem escrita de profundidade
+void swRasterPoint(const SwPoint& p, int x0, int y0, int x1, int y1) {
+    uint32_t c = swPack(p.gray, p.gray, p.gray);
+    for (int y = p.y; y < p.y + 2; ++y)
+        for (int x = p.x; x < p.x + 2; ++x)
+            if (x >= x0 && x <= x1 && y >= y0 && y <= y1) sw.color[(size_t)y * sw.width + x] = c;
+}
+
+// Partículas dos cinturões: um pixel com teste de profundidade
+// Rochas menores que um pixel somam luz (sem gravar profundidade), como no GL
+void swRasterParticle(const SwParticle& p) {
+    size_t idx = (size_t)p.y * sw.width + p.x;
+    if (p.z < 0.0f || p.z >= sw.depth[idx]) return;
+    __m128i sum = _mm_adds_epu8(_mm_cvtsi32_si128((int)sw.color[idx]), _mm_cvtsi32_si128((int)p.color));
+    sw.color[idx] = (uint32_t)_mm_cvtsi128_si32(sum);
+}
+
+// Lote de um cinturão: posições (SSE), projeção e cor de cada partícula
+struct SwBeltCtx {
+    int belt, firstBatch;           // primeiro lote deste cinturão em particleCounts
+    Mat4 vp;
+    float sun[3], eye[3];           // relativos à origem flutuante
+    __m128 fine, coarse;
+    float pixelScale;
+};
+
+void swBeltBatch(void* ctx, int batch) {
+    const SwBeltCtx& c = *(const SwBeltCtx*)ctx;
+    const Belt& b = belts[c.belt];
+    const float* tint = beltSpecs[c.belt].color;
+    int first = batch * BELT_BATCH, end = std::min(b.count, first + BELT_BATCH);
+    int slot = c.firstBatch + batch, n = 0;
+    SwParticle* out = &sw.particles[(size_t)slot * BELT_BATCH];
+    for (int i = first; i < end; i += 4) {
+        __m128 x, y, z;
+        beltPositions4(b, i, c.fine, c.coarse, &x, &y, &z);
+        float px[4], py[4], pz[4];
+        _mm_storeu_ps(px, x);
+        _mm_storeu_ps(py, y);
+        _mm_storeu_ps(pz, z);
+        for (int lane = 0; lane < 4; ++lane) {
+            float p[4] = {c.sun[0] + px[lane], c.sun[1] + py[lane], c.sun[2] + pz[lane], 1.0f}, clip[4];
+            mat4Apply(c.vp, p, clip);
+            if (clip[3] <= 0.0f || clip[2] < -clip[3] || clip[2] > clip[3]) continue;
+            float iw = 1.0f / clip[3];
+            int sx = (int)floorf((clip[0] * iw * 0.5f + 0.5f) * sw.width);
+            int sy = (int)floorf((clip[1] * iw * 0.5f + 0.5f) * sw.height);
+            if (sx < 0 || sy < 0 || sx >= sw.width || sy >= sw.height) continue;
+            // LOD: menor que um pixel, o brilho cai com a área projetada; fase vista da câmera
+            float diameter = 2.0f * b.radius[i + lane] * c.pixelScale * iw;
+            float coverage = std::max(std::min(diameter * diameter, 1.0f), BELT_MIN_COVERAGE);
+            float toSun[3] = {-px[lane], -py[lane], -pz[lane]}, toEye[3];
+            for (int k = 0; k < 3; ++k) toEye[k] = c.eye[k] - p[k];
+            float cosPhase = (toSun[0] * toEye[0] + toSun[1] * toEye[1] + toSun[2] * toEye[2])
+                           / sqrtf((toSun[0] * toSun[0] + toSun[1] * toSun[1] + toSun[2] * toSun[2])
+                                   * (toEye[0] * toEye[0] + toEye[1] * toEye[1] + toEye[2] * toEye[2]) + 1e-30f);
+            float k = b.albedo[i + lane] * coverage * (0.15f + 0.85f * (0.5f + 0.5f * cosPhase));
+            SwParticle& o = out[n++];
+            o.x = sx;
+            o.y = sy;
+            o.z = clip[2] * iw * 0.5f + 0.5f;
+            o.color = swPack(tint[0] * k, tint[1] * k, tint[2] * k);
+        }
+    }
+    sw.particleCounts[slot] = n;
+}
+
+// Cinturões no rasterizador: os lotes rodam no pool; o binning é serial
+void swSubmitBelts(const Mat4& vp, const float sun[3], const float eye[3], int height) {
+    TRACE_SCOPE("sw: cinturoes");
+    int batches[BELTS], total = 0;
+    for (int k = 0; k < BELTS; ++k) {
+        batches[k] = (belts[k].count + BELT_BATCH - 1) / BELT_BATCH;
+        total += batches[k];
+    }
+    sw.particles.resize((size_t)total * BELT_BATCH);
+    sw.particleCounts.assign(total, 0);
+    float fine, coarse;
+    beltPhases(t, &fine, &coarse);
+    SwBeltCtx ctx;
+    ctx.vp = vp;
+    for (int k = 0; k < 3; ++k) { ctx.sun[k] = sun[k]; ctx.eye[k] = eye[k]; }
+    ctx.fine = _mm_set1_ps(fine);
+    ctx.coarse = _mm_set1_ps(coarse);
+    ctx.pixelScale = height / (2.0f * tanf(30.0f * (float)M_PI / 180.0f));
+    ctx.firstBatch = 0;
+    for (int k = 0; k < BELTS; ++k) {
+        ctx.belt = k;
+        parallelFor(batches[k], swBeltBatch, &ctx);
+        ctx.firstBatch += batches[k];
+    }
+    for (int slot = 0; slot < total; ++slot)
+        for (int j = 0; j < sw.particleCounts[slot]; ++j) {
+            uint32_t idx = (uint32_t)slot * BELT_BATCH + j;
+            const SwParticle& p = sw.particles[idx];
+            swBin((SW_PARTICLE << 30) | idx, p.x, p.y, p.x, p.y);
+        }
+}
+
+// Cometas: poucas dezenas de milhares de pontos, direto na thread principal
+// (depois dos cinturões, que ocupam o começo de sw.particles)
+void swSubmitComets(const Mat4& vp, const float sun[3]) {
+    TRACE_SCOPE("sw: cometas");
+    for (int i = 0; i < cometVertCount; ++i) {
+        const CometVertex& v = cometVerts[i];
+        float p[4] = {sun[0] + v.pos[0], sun[1] + v.pos[1], sun[2] + v.pos[2], 1.0f}, clip[4];
+        mat4Apply(vp, p, clip);
+        if (clip[3] <= 0.0f || clip[2] < -clip[3] || clip[2] > clip[3]) continue;
+        float iw = 1.0f / clip[3];
+        SwParticle o;
+        o.x = (int)floorf((clip[0] * iw * 0.5f + 0.5f) * sw.width);
+        o.y = (int)floorf((clip[1] * iw * 0.5f + 0.5f) * sw.height);
+        if (o.x < 0 || o.y < 0 || o.x >= sw.width || o.y >= sw.height) continue;
+        o.z = clip[2] * iw * 0.5f + 0.5f;
+        o.color = swPack(v.color[0], v.color[1], v.color[2]);
+        sw.particles.push_back(o);
+        swBin((SW_PARTICLE << 30) | (uint32_t)(sw.particles.size() - 1), o.x, o.y, o.x, o.y);
+    }
+}
+
+void swRasterTile(void*, int tile) {
+    int tx = tile % sw.tilesX, ty = tile / sw.tilesX;
+    int x0 = tx * SW_TILE, y0 = ty * SW_TILE;
+    int x1 = std::min(x0 + SW_TILE, sw.width) - 1, y1 = std::min(y0 + SW_TILE, sw.height) - 1;
+
+    for (int y = y0; y <= y1; ++y) {                 // limpa só o próprio ladrilho
+        std::fill(&sw.color[(size_t)y * sw.width + x0], &sw.color[(size_t)y * sw.width + x1] + 1, 0xFF000000u);
+        std::fill(&sw.depth[(size_t)y * sw.width + x0], &sw.depth[(size_t)y * sw.width + x1] + 1, 1.0f);
+    }
+    for (int i = sw.binStart[tile]; i < sw.binStart[tile + 1]; ++i) {
+        uint32_t prim = sw.binPrims[i], type = prim >> 30, idx = prim & 0x3FFFFFFF;
+        if (type == SW_TRI) swRasterTriangle(sw.tris[idx], x0, y0, x1, y1);
+        else if (type == SW_LINE) swRasterLine(sw.lines[idx], x0, y0, x1, y1);
+        else if (type == SW_POINT) swRasterPoint(sw.points[idx], x0, y0, x1, y1);
+        else swRasterParticle(sw.particles[idx]);
+    }
+}
+
+// Renderiza a mesma cena de display() no framebuffer em RAM (sw.color).
+// Só a vista principal: os layouts de várias vistas (--views, tecla 'v')
+// existem apenas no OpenGL.
+void renderSoftware(int width, int height) {
+    TRACE_SCOPE("render software");
+    static bool warnedViews = false;
+    if (viewLayout != 0 && !warnedViews) {
+        printf("Vistas: o rasterizador em software desenha so a vista principal\n");
+        warnedViews = true;
+    }
+    swInit();
+    swResize(width, height);
+    sw.tris.clear();
+    sw.lines.clear();
+    sw.points.clear();
+    sw.particles.clear();
+    sw.binEntries.clear();
+
+    float eye[3], center[3], up[3];
+    cameraView(eye, center, up);
+    sw.view = mat4LookAt(eye, center, up);
+    sw.proj = mat4Perspective(60.0f, (float)width / height, sceneNear, sceneFar);
+    Mat4 vp = mat4Mul(sw.proj, sw.view);
+    BodyInstance bodies[NUM_BODIES];
+    int count = computeBodies(bodies);
+    float sunPos[4] = {bodies[0].pos[0], bodies[0].pos[1], bodies[0].pos[2], 1}, lightEye[4];
+    mat4Apply(sw.view, sunPos, lightEye);
+    for (int i = 0; i < 3; ++i) sw.lightEye[i] = lightEye[i];
+
+    {
+        TRACE_SCOPE("sw: geometria");
+        // Estrelas
+        for (int i = 0; i < NUM_STARS; ++i) {
+            float p[4] = {stars[i].x, stars[i].y, stars[i].z, 1.0f}, c[4];
+            for (int k = 0; k < 3; ++k) p[k] += trueScale ? eye[k] : bodies[0].pos[k];   // céu preso à câmera / ao Sol
+            mat4Apply(vp, p, c);
+            if (c[3] <= 0.0f || c[2] < -c[3] || c[2] > c[3]) continue;
+            SwPoint pt;
+            pt.x = (int)floorf((c[0] / c[3] * 0.5f + 0.5f) * width - 0.5f);
+            pt.y = (int)floorf((c[1] / c[3] * 0.5f + 0.5f) * height - 0.5f);
+            if (pt.x < -1 || pt.y < -1 || pt.x >= width || pt.y >= height) continue;
+            float tw = 0.85f + 0.15f * (0.5f + 0.5f * sinf(twinklePhase() + stars[i].phase));
+            pt.gray = stars[i].base * tw;
+            sw.points.push_back(pt);
+            swBin((SW_POINT << 30) | (uint32_t)(sw.points.size() - 1),
+                  std::max(pt.x, 0), std::max(pt.y, 0), std::min(pt.x + 1, width - 1), std::min(pt.y + 1, height - 1));
+        }
+
+        static std::vector<SwClipVertex> scratch;
+        const float white[3] = {1, 1, 1}, black[3] = {0, 0, 0};
+        const float ringColor[3] = {0.8f, 0.8f, 0.6f};
+
+        // Sol
+        Mat4 sunModel = mat4Mul(mat4Translate(bodies[0].pos[0], bodies[0].pos[1], bodies[0].pos[2]), mat4Scale(bodies[0].radius));
+        swDrawMesh(sw.sunMesh, sunModel, white, sunLight().emission, true, 0, true, scratch);
+
+        // Órbitas
+        if (showOrbits) {
+            const int segments = 800;
+            for (int i = 0; i < 8; ++i)
+                for (int j = 0; j < segments; ++j) {
+                    float a0 = 2.0f * (float)M_PI * j / segments, a1 = 2.0f * (float)M_PI * (j + 1) / segments;
+                    float p0[3] = {(float)(orbitRadii[i] * cos(a0) - worldOrigin[0]), (float)-worldOrigin[1],
+                                   (float)(orbitRadii[i] * sin(a0) - worldOrigin[2])};
+                    float p1[3] = {(float)(orbitRadii[i] * cos(a1) - worldOrigin[0]), (float)-worldOrigin[1],
+                                   (float)(orbitRadii[i] * sin(a1) - worldOrigin[2])};
+                    swSubmitLine(p0, p1, vp, white);
+                }
+        }
+
+        // Planetas (+ anel)
+        for (int i = 1; i < count; ++i) {
+            const BodyInstance& b = bodies[i];
+            Mat4 base = mat4Translate(b.pos[0], b.pos[1], b.pos[2]);
+            if (b.hasRing) {
+                if (b.ring.inner != sw.ringShape.inner || b.ring.outer != sw.ringShape.outer) {
+                    sw.ringMesh = buildRingMesh(b.ring.inner, b.ring.outer, 100);
+                    sw.ringShape = b.ring;
+                }
+                Mat4 ring = mat4Mul(mat4Mul(base, mat4Rotate(b.ring.tiltDeg, 1, 0, 0)), mat4Scale(b.radius));
+                swDrawMesh(sw.ringMesh, ring, ringColor, black, false, -1, false, scratch);
+            }
+            Mat4 rot = {{b.rot[0], b.rot[1], b.rot[2], 0, b.rot[3], b.rot[4], b.rot[5], 0,
+                         b.rot[6], b.rot[7], b.rot[8], 0, 0, 0, 0, 1}};
+            Mat4 model = mat4Mul(mat4Mul(base, rot), mat4Scale(b.radius));
+            swDrawMesh(sw.planetMesh, model, b.tint, black, true, b.texture, true, scratch);
+        }
+    }
+    if (showBelts) swSubmitBelts(vp, bodies[0].pos, eye, height);
+    if (showComets) swSubmitComets(vp, bodies[0].pos);
+
+    TRACE_SCOPE("sw: ladrilhos");
+    swSortBins();
+    parallelFor(sw.tilesX * sw.tilesY, swRasterTile, NULL);
+}
+
+// Salva um framebuffer RGBA (linha 0 embaixo) como PPM binário
+bool writePPM(const char* path, const uint32_t* pixels, int width, int height) {
+    FILE* f = fopen(path, "wb");
+    if (!f) { printf("Erro ao criar %s\n", path); return false; }
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    std::vector<unsigned char> row((size_t)width * 3);
+    for (int y = height - 1; y >= 0; --y) {
+        for (int x = 0; x < width; ++x) {
+            uint32_t p = pixels[(size_t)y * width + x];
+            row[x*3] = p & 0xFF; row[x*3+1] = (p >> 8) & 0xFF; row[x*3+2] = (p >> 16) & 0xFF;
+        }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    fclose(f);
+    return true;
+}
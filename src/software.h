@@ -0,0 +1,70 @@
+// Rasterizador em software por ladrilhos (para nós sem GPU)
+#ifndef SOLAR_SOFTWARE_H
+#define SOLAR_SOFTWARE_H
+
+#include "common.h"
+#include "bodies.h"
+#include "camera.h"
+
+struct SwVertex {
+    float pos[3], normal[3], uv[2];
+};
+
+struct SwMesh {
+    std::vector<SwVertex> verts;
+    std::vector<unsigned> indices;
+};
+
+struct SwTriangle {
+    float x[3], y[3], z[3], invW[3];
+    float color[3][3];       // cor / w
+    float uv[3][2];          // uv / w
+    int texture;             // -1 = sem textura
+    int minX, minY, maxX, maxY;
+};
+
+struct SwLine {
+    float x0, y0, z0, x1, y1, z1;
+    float color[3];
+};
+
+struct SwPoint {
+    int x, y;
+    float gray;
+};
+
+struct SwParticle {
+    int x, y;
+    float z;
+    uint32_t color;
+};
+
+struct SwRenderer {
+    int width = 0, height = 0, tilesX = 0, tilesY = 0;
+    std::vector<uint32_t> color;            // RGBA8, linha 0 embaixo (como glDrawPixels)
+    std::vector<float> depth;
+    std::vector<SwTriangle> tris;
+    std::vector<SwLine> lines;
+    std::vector<SwPoint> points;
+    std::vector<SwParticle> particles;      // cinturões: cada lote do pool escreve na sua faixa
+    std::vector<int> particleCounts;        // partículas visíveis em cada lote
+    std::vector<uint64_t> binEntries;       // (ladrilho << 32) | (tipo << 30) | índice, na ordem de envio
+    std::vector<uint32_t> binPrims;         // as mesmas agrupadas por ladrilho (ordem de envio mantida)
+    std::vector<int> binStart, binCursor;   // binPrims[binStart[t] .. binStart[t + 1]) = ladrilho t
+    Mat4 view, proj;
+    float lightEye[3];
+    SwMesh sunMesh, planetMesh, ringMesh;
+    Ring ringShape = {0, 0, 0};             // raios de ringMesh, em raios do corpo
+};
+
+extern SwRenderer sw;
+extern bool softwareBackend; // tecla 'r' ou --software
+
+inline uint32_t swPack(float r, float g, float b) {
+    return (uint32_t)(r * 255.0f + 0.5f) | (uint32_t)(g * 255.0f + 0.5f) << 8 | (uint32_t)(b * 255.0f + 0.5f) << 16 | 0xFF000000u;
+}
+
+void renderSoftware(int width, int height);
+bool writePPM(const char* path, const uint32_t* pixels, int width, int height);
+
+#endif
@@ -0,0 +1,66 @@
+#include "stars.h"
+
+#include "app.h"
+#include "bodies.h"
+#include "render.h"
+#include "runtime.h"
+
+// Reprodutibilidade (gravação/replay de sessões)
+unsigned starSeed = 0;
+
+Star stars[NUM_STARS];
+const float STAR_RADIUS = 220.0f;           // raio da esfera de estrelas (atrás de tudo)
+
+// Gerar estrelas numa esfera
+void initStars() {
+    srand(starSeed);                        // seed do RNG (gravada junto com o replay)
+    for (int i = 0; i < NUM_STARS; ++i) {
+        // amostragem uniforme na esfera (transforma de coordenadas esféricas para cartesianas)
+        float u = (float)rand() / RAND_MAX;
+        float v = (float)rand() / RAND_MAX;
+        float theta = 2.0f * M_PI * u;
+        float z = 2.0f * v - 1.0f;
+        float r = sqrtf(1.0f - z*z);
+        float x = r * cosf(theta);
+        float y = r * sinf(theta);
+        stars[i].x = STAR_RADIUS * x;       // empurra para o raio do céu
+        stars[i].y = STAR_RADIUS * y;
+        stars[i].z = STAR_RADIUS * z;
+
+        stars[i].base  = 0.6f + 0.4f * ((float)rand() / RAND_MAX); // brilho base aleatório
+        stars[i].phase = 20.0f * ((float)rand() / RAND_MAX);       // fase da cintilação
+    }
+}
+
+// Brilho de cada estrela no quadro atual (cintilação leve: varia com seno no tempo)
+float twinklePhase() {
+    return (float)wrapPeriod(0.6 * t, 2.0 * M_PI);
+}
+
+void computeStarColors(float colors[NUM_STARS * 3]) {
+    float phase = twinklePhase();
+    for (int i = 0; i < NUM_STARS; ++i) {
+        float tw = 0.85f + 0.15f * (0.5f + 0.5f * sinf(phase + stars[i].phase));
+        float b = stars[i].base * tw;      // brilho final
+        colors[i * 3] = colors[i * 3 + 1] = colors[i * 3 + 2] = b;
+    }
+}
+
+// Desenhar o céu estrelado (cores já calculadas para o quadro)
+void drawStars(const float* colors) {
+    TRACE_SCOPE("estrelas");
+    setLighting(false);         // estrelas não recebem iluminação (pontos simples)
+    glDepthMask(GL_FALSE);      // não escreve no depth (ficam "atrás" sem bloquear)
+    glPointSize(1.5f * renderScale); // tamanho de cada estrela
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Star), &stars[0].x);
+    glColorPointer(3, GL_FLOAT, 0, colors);
+    glDrawArrays(GL_POINTS, 0, NUM_STARS);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glDepthMask(GL_TRUE);
+    setLighting(true);
+}
@@ -0,0 +1,24 @@
+// Céu de estrelas com cintilação
+#ifndef SOLAR_STARS_H
+#define SOLAR_STARS_H
+
+#include "common.h"
+
+extern unsigned starSeed; // seed das estrelas (--seed=N; padrão: hora atual)
+
+// Estrelas (céu)
+struct Star {
+    float x, y, z;   // posição 3D fixa na esfera de céu
+    float base;      // brilho base [0..1]
+    float phase;     // fase para cintilação (desloca o seno)
+};
+
+const int NUM_STARS = 2000;                 // quantidade de estrelas
+extern Star stars[NUM_STARS];
+
+void initStars();
+float twinklePhase();
+void computeStarColors(float colors[NUM_STARS * 3]);
+void drawStars(const float* colors);
+
+#endif
@@ -0,0 +1,4 @@
+// Decodificador do stb_image numa unidade de tradução própria: o header tem
+// quase 300 KB e só muda quando o stb é atualizado
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
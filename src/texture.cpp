@@ -0,0 +1,506 @@
+#include "texture.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+
+#include "decode.h"
+#include "render.h"
+
+// IDs das texturas
+GLuint planetTextures[8];
+GLuint sunTexture;
+const char* planetNames[8] = {"mercury","venus","earth","mars","jupiter","saturn","uranus","neptune"};
+bool usePack = true;
+bool coldStart = false;
+int textureScale = 1;
+
+// Carregar textura (seguro): força RGBA, corrige alinhamento e
+// permite optar por CLAMP_TO_EDGE (para o Sol).
+GLuint loadTexture(const char* filename, bool clampToEdge = false) {
+    int w, h;
+    std::vector<unsigned char> data;        // RGBA, já com a linha 0 embaixo (sem inverter depois)
+    if (!decodeImageFile(filename, textureScale, data, &w, &h)) {
+        printf("Erro ao carregar textura: %s\n", filename);
+        return 0;
+    }
+
+    GLuint texID;
+    glGenTextures(1, &texID);              // gera ID de textura
+    glBindTexture(GL_TEXTURE_2D, texID);   // seleciona a textura atual
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // evita listras (alinhamento por 1 byte)
+
+    // filtros de min/mag (mipmap para longe, linear para perto)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // tipo de repetição nas bordas (clamp evita halos em PNG com transparência)
+    GLint wrap = clampToEdge ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+
+    // envia pixels para a GPU + gera mipmaps (via GLU)
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA8, w, h, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+    return texID;                           // retorna handle da textura
+}
+
+// --cold-start: tira o pacote e os arquivos soltos do page cache antes da
+// carga (posix_fadvise basta para páginas limpas, sem root), para medir a
+// partida a frio com o mesmo binário
+void evictTextureFiles() {
+    char path[256];
+    for (int i = -1; i < 9; ++i) {
+        if (i < 0) snprintf(path, sizeof(path), "textures.pack");
+        else snprintf(path, sizeof(path), "textures/%s.jpg", i == 0 ? "sun" : planetNames[i - 1]);
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) continue;
+        fdatasync(fd);                          // páginas sujas (pacote recém-gerado) não saem
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+TexturePack texPack;
+
+bool openTexturePack(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(PackHeader)) { close(fd); return false; }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const PackHeader* hdr = (const PackHeader*)map;
+    size_t indexEnd = sizeof(PackHeader) + (size_t)hdr->count * sizeof(PackEntry);
+    if (hdr->magic != PACK_MAGIC || hdr->version != PACK_VERSION || indexEnd > (size_t)st.st_size ||
+        packChecksum(hdr + 1, indexEnd - sizeof(PackHeader)) != hdr->indexChecksum) {
+        printf("Pacote de texturas invalido: %s\n", path);
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    texPack.base = (const unsigned char*)map;
+    texPack.size = st.st_size;
+    texPack.header = hdr;
+    texPack.entries = (const PackEntry*)(hdr + 1);
+
+    // Quantas páginas já estavam no page cache (distingue partida a frio/quente)
+    long page = sysconf(_SC_PAGESIZE);
+    size_t pages = (texPack.size + page - 1) / page;
+    std::vector<unsigned char> resident(pages);
+    if (mincore(map, texPack.size, resident.data()) == 0) {
+        size_t n = 0;
+        for (size_t i = 0; i < pages; ++i) n += resident[i] & 1;
+        texPack.residentBefore = (float)n / pages;
+    }
+    madvise(map, texPack.size, MADV_WILLNEED);          // antecipa a leitura do disco
+    return true;
+}
+
+void closeTexturePack() {
+    if (texPack.base) munmap((void*)texPack.base, texPack.size);   // o glTexImage2D já copiou
+    texPack = TexturePack();
+}
+
+// Carrega uma textura do pacote (mips prontos, sem decodificar). Retorna 0 se
+// não existir no pacote ou se estiver corrompida.
+GLuint loadTextureFromPack(const char* name, bool clampToEdge = false) {
+    if (!texPack.base) return 0;
+    const PackEntry* e = NULL;
+    for (uint32_t i = 0; i < texPack.header->count; ++i)
+        if (strncmp(texPack.entries[i].name, name, sizeof(e->name)) == 0) e = &texPack.entries[i];
+    if (!e || e->mipCount == 0 || e->mipCount > (uint32_t)PACK_MAX_MIPS) return 0;
+    if (e->format != PACK_RGBA8 && e->format != PACK_DXT1) return 0;
+    if (e->width == 0 || e->height == 0 || e->width > PACK_MAX_SIZE || e->height > PACK_MAX_SIZE) return 0;
+    if (e->format == PACK_DXT1 && !hasExtension("GL_EXT_texture_compression_s3tc")) return 0;
+
+    // O checksum só prova que os bytes são os gravados; o tamanho de cada mip
+    // tem que bater com largura, altura e formato, senão o glTexImage2D leria
+    // além do mip (e talvez além do mapeamento)
+    uint64_t checksum = 0xcbf29ce484222325ULL;
+    for (uint32_t m = 0; m < e->mipCount; ++m) {
+        uint32_t w = std::max(e->width >> m, 1u), h = std::max(e->height >> m, 1u);
+        if (e->mipSize[m] != packMipSize(e->format, w, h) || e->mipOffset[m] > texPack.size ||
+            e->mipSize[m] > texPack.size - e->mipOffset[m]) {
+            printf("Indice invalido no pacote: %s (mip %u)\n", name, m);
+            return 0;
+        }
+        checksum = packChecksum(texPack.base + e->mipOffset[m], e->mipSize[m], checksum);
+    }
+    if (checksum != e->checksum) {
+        printf("Checksum invalido no pacote: %s\n", name);
+        return 0;
+    }
+
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D, texID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, e->mipCount - 1);
+    GLint wrap = clampToEdge ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+
+    // Upload direto do mapeamento: a única cópia na CPU é a do driver, que lê
+    // as páginas do page cache (uma cópia intermediária para um PBO só
+    // somaria outra)
+    for (uint32_t m = 0; m < e->mipCount; ++m) {
+        GLsizei w = e->width >> m, h = e->height >> m;
+        if (w < 1) w = 1;
+        if (h < 1) h = 1;
+        const void* src = texPack.base + e->mipOffset[m];
+        if (e->format == PACK_DXT1)
+            glCompressedTexImage2D(GL_TEXTURE_2D, m, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, w, h, 0, e->mipSize[m], src);
+        else
+            glTexImage2D(GL_TEXTURE_2D, m, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, src);
+    }
+    return texID;
+}
+
+const size_t STAGING_SLOT_SIZE = 8u << 20;   // 8 MB: comporta o sun.jpg (2048x1024 RGBA)
+
+TextureUploader uploader;
+
+// Reserva uma região livre do anel (bloqueia a decodificadora até haver uma;
+// NULL se o programa está saindo)
+StagingSlot* acquireStagingSlot() {
+    std::unique_lock<std::mutex> lock(uploader.mutex);
+    while (!uploader.stopping) {
+        for (int i = 0; i < STAGING_SLOTS; ++i) {
+            int expected = SLOT_FREE;
+            if (uploader.slots[i].state.compare_exchange_strong(expected, SLOT_DECODING))
+                return &uploader.slots[i];
+        }
+        uploader.slotFreed.wait(lock);
+    }
+    return NULL;
+}
+
+// Destino das decodificadoras: os pixels vão direto para uma região do anel.
+// A região é reservada uma vez por job, mesmo que um backend desista no meio
+// e o próximo tente de novo. O que não cabe numa região vai para a RAM.
+struct StagingSink {
+    StagingSlot* slot;
+    std::vector<unsigned char> large;
+    int w, h;
+};
+
+unsigned char* stagingSink(void* ctx, int w, int h) {
+    StagingSink* s = (StagingSink*)ctx;
+    s->w = w;
+    s->h = h;
+    if ((size_t)w * h * 4 > STAGING_SLOT_SIZE) {
+        s->large.resize((size_t)w * h * 4);
+        return s->large.data();
+    }
+    if (!s->slot) s->slot = acquireStagingSlot();
+    return s->slot ? s->slot->mem : NULL;
+}
+
+void decoderThread() {
+    for (;;) {
+        UploadJob job;
+        {
+            std::unique_lock<std::mutex> lock(uploader.mutex);
+            uploader.jobAvailable.wait(lock, [] { return uploader.jobsHead || uploader.stopping; });
+            if (uploader.stopping) return;
+            UploadJob* node = uploader.jobsHead;
+            uploader.jobsHead = node->next;
+            if (!uploader.jobsHead) uploader.jobsTail = NULL;
+            job = *node;
+            uploader.jobPool.destroy(node);
+        }
+        TRACE_SCOPE("decodificar textura");
+        StagingSink sink = {NULL, {}, 0, 0};
+        bool ok = decodeImageFile(job.path, textureScale, stagingSink, &sink);
+        if (ok && sink.large.size() == (size_t)sink.w * sink.h * 4) {
+            if (sink.slot) {                      // um backend desistiu depois de reservar
+                std::lock_guard<std::mutex> lock(uploader.mutex);
+                sink.slot->state.store(SLOT_FREE, std::memory_order_release);
+                uploader.slotFreed.notify_all();
+            }
+            std::lock_guard<std::mutex> lock(uploader.mutex);
+            uploader.large.push_back(LargeUpload{job, std::move(sink.large), sink.w, sink.h});
+            uploader.largeReady.store(1, std::memory_order_release);
+            continue;
+        }
+        if (!ok) {
+            if (!sink.slot && sink.large.empty()) {
+                std::lock_guard<std::mutex> lock(uploader.mutex);
+                if (uploader.stopping) return;    // saindo: sem região para decodificar
+            }
+            printf("Erro ao carregar textura: %s\n", job.path);
+            if (sink.slot) {
+                std::lock_guard<std::mutex> lock(uploader.mutex);
+                sink.slot->state.store(SLOT_FREE, std::memory_order_release);
+                uploader.slotFreed.notify_all();
+            }
+            uploader.pending--;
+            continue;
+        }
+        StagingSlot* slot = sink.slot;
+        slot->w = sink.w;
+        slot->h = sink.h;
+        slot->job = job;
+        slot->state.store(SLOT_READY, std::memory_order_release);
+    }
+}
+
+// As decodificadoras esperam em condvars do uploader, que é destruído com os
+// estáticos: na saída elas são acordadas e aguardadas antes disso. Jobs ainda
+// na fila são descartados.
+void stopTextureUploaderAtExit() {
+    {
+        std::lock_guard<std::mutex> lock(uploader.mutex);
+        uploader.stopping = true;
+    }
+    uploader.jobAvailable.notify_all();
+    uploader.slotFreed.notify_all();
+    for (int i = 0; i < DECODER_THREADS; ++i) uploader.decoders[i].join();
+}
+
+void startTextureUploader() {
+    if (uploader.started) return;
+    size_t total = STAGING_SLOT_SIZE * STAGING_SLOTS;
+    unsigned char* base = NULL;
+    if (hasExtension("GL_ARB_buffer_storage")) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &uploader.pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploader.pbo);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, total, NULL, flags);
+        base = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, total, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!base) {
+            glDeleteBuffers(1, &uploader.pbo);
+            uploader.pbo = 0;
+        }
+    }
+    if (!base) {                                  // sem PBO persistente: upload da RAM
+        uploader.fallbackMem.resize(total);
+        base = uploader.fallbackMem.data();
+    }
+    for (int i = 0; i < STAGING_SLOTS; ++i) {
+        uploader.slots[i].offset = STAGING_SLOT_SIZE * i;
+        uploader.slots[i].mem = base + uploader.slots[i].offset;
+    }
+    for (int i = 0; i < DECODER_THREADS; ++i)
+        uploader.decoders[i] = std::thread(decoderThread);
+    uploader.started = true;
+    atexit(stopTextureUploaderAtExit);
+}
+
+// Agenda a decodificação + upload; *target recebe o novo ID quando pronto
+void requestTextureAsync(const char* path, GLuint* target, bool clampToEdge = false) {
+    startTextureUploader();
+    uploader.pending++;
+    {
+        std::lock_guard<std::mutex> lock(uploader.mutex);
+        UploadJob* job = uploader.jobPool.create();
+        snprintf(job->path, sizeof(job->path), "%s", path);
+        job->target = target;
+        job->clampToEdge = clampToEdge;
+        job->next = NULL;
+        if (uploader.jobsTail) uploader.jobsTail->next = job;
+        else uploader.jobsHead = job;
+        uploader.jobsTail = job;
+    }
+    uploader.jobAvailable.notify_one();
+}
+
+// Cria a textura de um job decodificado e a troca no destino
+void uploadDecodedTexture(const UploadJob& job, int w, int h, const void* src) {
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D, texID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLint wrap = job.clampToEdge ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, src);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    if (*job.target) glDeleteTextures(1, job.target);   // troca em tempo de execução
+    *job.target = texID;
+    uploader.pending--;
+}
+
+// Chamado a cada quadro na thread do GL: envia as regiões prontas e recicla
+// as que a GPU já consumiu. Nunca bloqueia.
+void pollTextureUploads() {
+    if (!uploader.started) return;
+    TRACE_SCOPE("uploads de textura");
+    if (uploader.largeReady.load(std::memory_order_acquire)) {
+        std::vector<LargeUpload> large;
+        {
+            std::lock_guard<std::mutex> lock(uploader.mutex);
+            large.swap(uploader.large);
+            uploader.largeReady.store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < large.size(); ++i)        // da RAM, sem PBO
+            uploadDecodedTexture(large[i].job, large[i].w, large[i].h, large[i].rgba.data());
+    }
+    bool freed = false;
+    for (int i = 0; i < STAGING_SLOTS; ++i) {
+        StagingSlot& slot = uploader.slots[i];
+        int state = slot.state.load(std::memory_order_acquire);
+
+        if (state == SLOT_READY) {
+            const void* src = slot.mem;
+            if (uploader.pbo) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploader.pbo);
+                src = (const void*)(uintptr_t)slot.offset;
+            }
+            uploadDecodedTexture(slot.job, slot.w, slot.h, src);
+            if (uploader.pbo) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            if (uploader.pbo) {
+                slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                slot.state.store(SLOT_UPLOADED, std::memory_order_relaxed);
+            } else {                              // glTexImage2D já copiou da RAM
+                slot.state.store(SLOT_FREE, std::memory_order_release);
+                freed = true;
+            }
+        } else if (state == SLOT_UPLOADED) {
+            if (glClientWaitSync(slot.fence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+                glDeleteSync(slot.fence);
+                slot.fence = 0;
+                slot.state.store(SLOT_FREE, std::memory_order_release);
+                freed = true;
+            }
+        }
+    }
+    if (freed) {
+        std::lock_guard<std::mutex> lock(uploader.mutex);
+        uploader.slotFreed.notify_all();
+    }
+}
+
+// Recarrega todas as texturas dos arquivos em segundo plano (a cena continua
+// com as texturas atuais até as novas chegarem)
+void reloadTexturesAsync() {
+    char path[256];
+    requestTextureAsync("textures/sun.jpg", &sunTexture, true);
+    for (int i = 0; i < 8; ++i) {
+        snprintf(path, sizeof(path), "textures/%s.jpg", planetNames[i]);
+        requestTextureAsync(path, &planetTextures[i]);
+    }
+}
+
+// Textura por nome: pacote primeiro, arquivo solto (textures/<nome>.jpg) como reserva
+GLuint loadNamedTexture(const char* name, bool clampToEdge) {
+    GLuint tex = loadTextureFromPack(name, clampToEdge);
+    if (tex) return tex;
+    char path[256];
+    snprintf(path, sizeof(path), "textures/%s.jpg", name);
+    return loadTexture(path, clampToEdge);
+}
+int deferredTexture = -1;
+unsigned deferredRequested = 0;        // bit i = textura do corpo i já pedida (0 = Sol)
+bool deferredWaiting = false;          // esperando os uploads assíncronos terminarem
+double deferredBegin = 0.0;
+
+// --fast-start: carrega uma textura por tick depois do primeiro quadro. Do
+// pacote é só um upload; sem pacote vai para as threads decodificadoras.
+void loadDeferredTexture() {
+    if (deferredTexture == 0) deferredBegin = nowMs();
+    // Ordem: o que está na tela, depois o que a câmera vai ver, depois o resto
+    unsigned missing = ~deferredRequested & 0x1FF;
+    unsigned pick = (missing & bodiesVisible) ? (missing & bodiesVisible)
+                  : (missing & bodiesSoon)    ? (missing & bodiesSoon) : missing;
+    int i = __builtin_ctz(pick);
+    deferredRequested |= 1u << i;
+    deferredTexture++;
+    bool clamp = (i == 0);
+    const char* name = (i == 0) ? "sun" : planetNames[i - 1];
+    GLuint* target = (i == 0) ? &sunTexture : &planetTextures[i - 1];
+    *target = loadTextureFromPack(name, clamp);
+    if (!*target) {
+        char path[256];
+        snprintf(path, sizeof(path), "textures/%s.jpg", name);
+        requestTextureAsync(path, target, clamp);
+    }
+    if (deferredTexture == 9) {
+        closeTexturePack();
+        deferredTexture = -1;
+        deferredWaiting = true;
+    }
+}
+
+void updateDeferredTextures() {
+    if (deferredTexture >= 0) loadDeferredTexture();
+    if (deferredWaiting && uploader.pending == 0) {
+        deferredWaiting = false;
+        startupRecord("texturas (segundo plano)", deferredBegin, nowMs());
+        finishStartupTrace();
+    }
+}
+
+CpuImage cpuTextures[9];
+bool cpuTexturesLoaded = false;
+
+void loadCpuTextures() {
+    if (cpuTexturesLoaded) return;
+    for (int i = 0; i < 9; ++i) {
+        char path[256];
+        snprintf(path, sizeof(path), "textures/%s.jpg", i == 0 ? "sun" : planetNames[i - 1]);
+        CpuImage& img = cpuTextures[i];
+        if (!decodeImageFile(path, textureScale, img.rgba, &img.w, &img.h)) {
+            printf("Erro ao carregar textura: %s\n", path);
+            img.w = img.h = 1;
+            img.rgba.assign(4, 255);
+            continue;
+        }
+        img.clampToEdge = (i == 0);
+    }
+    cpuTexturesLoaded = true;
+}
+
+// Amostragem bilinear (repeat ou clamp), resultado em [0,1]
+void sampleTexture(const CpuImage& img, float u, float v, float out[3]) {
+    if (img.clampToEdge) {
+        u = u < 0 ? 0 : (u > 1 ? 1 : u);
+        v = v < 0 ? 0 : (v > 1 ? 1 : v);
+    } else {
+        u -= floorf(u);
+        v -= floorf(v);
+    }
+    float fx = u * img.w - 0.5f, fy = v * img.h - 0.5f;
+    int x0 = (int)floorf(fx), y0 = (int)floorf(fy);
+    float ax = fx - x0, ay = fy - y0;
+    int x1 = x0 + 1, y1 = y0 + 1;
+    if (img.clampToEdge) {
+        x0 = x0 < 0 ? 0 : x0; y0 = y0 < 0 ? 0 : y0;
+        x1 = x1 >= img.w ? img.w - 1 : x1; y1 = y1 >= img.h ? img.h - 1 : y1;
+    } else {
+        x0 = (x0 + img.w) % img.w; x1 = x1 % img.w;
+        y0 = (y0 + img.h) % img.h; y1 = y1 % img.h;
+    }
+    const unsigned char* p00 = &img.rgba[((size_t)y0 * img.w + x0) * 4];
+    const unsigned char* p10 = &img.rgba[((size_t)y0 * img.w + x1) * 4];
+    const unsigned char* p01 = &img.rgba[((size_t)y1 * img.w + x0) * 4];
+    const unsigned char* p11 = &img.rgba[((size_t)y1 * img.w + x1) * 4];
+    for (int c = 0; c < 3; ++c) {
+        float top = p00[c] + (p10[c] - p00[c]) * ax;
+        float bot = p01[c] + (p11[c] - p01[c]) * ax;
+        out[c] = (top + (bot - top) * ay) * (1.0f / 255.0f);
+    }
+}
+
+// Coordenadas de textura de um ponto da esfera unitária, iguais às do gluSphere
+// (polos no eixo z local; s cresce com o ângulo theta, t = 1 no polo +z)
+void sphereTexCoord(const float n[3], float* s, float* t) {
+    float rho = acosf(n[2] < -1 ? -1 : (n[2] > 1 ? 1 : n[2]));
+    float theta = atan2f(-n[0], n[1]);
+    if (theta < 0) theta += 2.0f * (float)M_PI;
+    *s = theta / (2.0f * (float)M_PI);
+    *t = 1.0f - rho / (float)M_PI;
+}
@@ -0,0 +1,109 @@
+// Texturas: arquivos soltos (decode.h), pacote mapeado em memória, upload
+// assíncrono por PBO, carga adiada (--fast-start) e cópias em RAM
+#ifndef SOLAR_TEXTURE_H
+#define SOLAR_TEXTURE_H
+
+#include "common.h"
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include "texpack.h"
+#include "runtime.h"
+
+extern GLuint planetTextures[8]; // texturas dos planetas (uma para cada)
+extern GLuint sunTexture;        // textura do Sol
+extern const char* planetNames[8];
+extern bool usePack;             // tenta textures.pack antes dos arquivos soltos (--no-pack desliga)
+extern bool coldStart;           // --cold-start: esvazia o page cache das texturas antes de carregar
+extern int textureScale;         // --texture-scale=N: arquivos soltos decodificados em 1/N (1, 2, 4, 8)
+
+// Pacote de texturas (gerado pelo packer) mapeado em memória. Os mips já vêm
+// prontos; o glTexImage2D lê direto do mapeamento.
+struct TexturePack {
+    const unsigned char* base = NULL;   // início do arquivo mapeado
+    size_t size = 0;
+    const PackHeader* header = NULL;
+    const PackEntry* entries = NULL;
+    float residentBefore = 0.0f;        // fração já em cache antes de abrir (0 = partida a frio)
+};
+
+extern TexturePack texPack;
+
+void evictTextureFiles();
+
+bool openTexturePack(const char* path);
+void closeTexturePack();
+
+// Upload assíncrono de texturas: threads decodificadoras escrevem os pixels
+// direto num anel de regiões de um PBO persistente; a thread do GL só emite
+// glTexImage2D a partir do PBO e recicla a região quando a fence sinaliza.
+// Imagens maiores que uma região são decodificadas numa cópia na RAM e
+// enviadas sem PBO, como no carregamento síncrono.
+const int    STAGING_SLOTS     = 4;
+const int    DECODER_THREADS   = 2;
+enum SlotState { SLOT_FREE, SLOT_DECODING, SLOT_READY, SLOT_UPLOADED };
+
+struct UploadJob {
+    char path[256];
+    GLuint* target;          // onde gravar o novo ID (a textura antiga é apagada)
+    bool clampToEdge;
+    UploadJob* next;         // fila de pedidos (nós do pool)
+};
+
+struct StagingSlot {
+    std::atomic<int> state{SLOT_FREE};
+    unsigned char* mem = NULL;   // região do PBO (ou memória comum sem buffer storage)
+    size_t offset = 0;           // deslocamento da região dentro do PBO
+    int w = 0, h = 0;
+    UploadJob job;
+    GLsync fence = 0;
+};
+
+struct LargeUpload {
+    UploadJob job;
+    std::vector<unsigned char> rgba;
+    int w, h;
+};
+
+struct TextureUploader {
+    GLuint pbo = 0;
+    std::vector<unsigned char> fallbackMem;   // usado quando não há GL_ARB_buffer_storage
+    StagingSlot slots[STAGING_SLOTS];
+    NodePool<UploadJob> jobPool;
+    UploadJob* jobsHead = NULL;                // fila FIFO de pedidos (protegida por mutex)
+    UploadJob* jobsTail = NULL;
+    std::mutex mutex;
+    std::condition_variable jobAvailable, slotFreed;
+    std::vector<LargeUpload> large;            // prontas fora do anel (protegido por mutex)
+    std::atomic<int> largeReady{0};
+    std::atomic<int> pending{0};               // jobs ainda não enviados à GPU
+    std::thread decoders[DECODER_THREADS];
+    bool stopping = false;                     // saída do programa (protegido por mutex)
+    bool started = false;
+};
+
+extern TextureUploader uploader;
+
+void pollTextureUploads();
+void reloadTexturesAsync();
+GLuint loadNamedTexture(const char* name, bool clampToEdge = false);
+
+extern int deferredTexture; // texturas adiadas já pedidas (-1 = nenhuma pendente)
+
+void updateDeferredTextures();
+
+// Cópias das texturas em RAM (usadas pelos renderizadores em CPU)
+struct CpuImage {
+    int w = 0, h = 0;
+    bool clampToEdge = false;
+    std::vector<unsigned char> rgba;
+};
+
+extern CpuImage cpuTextures[9]; // 0 = Sol, 1..8 = planetas (mesma ordem de planetTextures)
+
+void loadCpuTextures();
+void sampleTexture(const CpuImage& img, float u, float v, float out[3]);
+void sphereTexCoord(const float n[3], float* s, float* t);
+
+#endif
@@ -0,0 +1,183 @@
+#include "video.h"
+
+#include <chrono>
+
+#include "app.h"
+#include "runtime.h"
+
+// ---------------------------------------------------------------------------
+// Gravação de vídeo: cada quadro é lido da GPU por um anel de PBOs (o
+// glReadPixels de um quadro só é mapeado N-1 quadros depois, sem travar),
+// copiado para uma fila limitada sem travas (produtor = thread do GL,
+// consumidor = thread escritora) e gravado em Y4M ou enviado a um ffmpeg.
+// O tempo da simulação segue a taxa do vídeo, não o glutTimerFunc.
+
+VideoRecorder video;
+
+// RGBA (linha 0 embaixo) -> YUV 4:2:0 (BT.601 faixa completa) em Y4M
+void writeY4MFrame(FILE* f, const unsigned char* rgba, int w, int h, std::vector<unsigned char>& yuv) {
+    yuv.resize((size_t)w * h * 3 / 2);
+    unsigned char* Y = yuv.data();
+    unsigned char* U = Y + (size_t)w * h;
+    unsigned char* V = U + (size_t)w * h / 4;
+    for (int y = 0; y < h; ++y) {
+        const unsigned char* row = rgba + (size_t)(h - 1 - y) * w * 4;
+        for (int x = 0; x < w; ++x) {
+            const unsigned char* p = row + x * 4;
+            Y[(size_t)y * w + x] = (unsigned char)(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2] + 0.5f);
+        }
+    }
+    for (int y = 0; y < h / 2; ++y)
+        for (int x = 0; x < w / 2; ++x) {
+            float r = 0, g = 0, b = 0;
+            for (int k = 0; k < 4; ++k) {
+                const unsigned char* p = rgba + ((size_t)(h - 1 - (2 * y + k / 2)) * w + 2 * x + k % 2) * 4;
+                r += p[0]; g += p[1]; b += p[2];
+            }
+            r *= 0.25f; g *= 0.25f; b *= 0.25f;
+            float u = 128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b;
+            float v = 128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b;
+            U[(size_t)y * (w / 2) + x] = (unsigned char)std::min(255.0f, std::max(0.0f, u + 0.5f));
+            V[(size_t)y * (w / 2) + x] = (unsigned char)std::min(255.0f, std::max(0.0f, v + 0.5f));
+        }
+    fputs("FRAME\n", f);
+    fwrite(yuv.data(), 1, yuv.size(), f);
+}
+
+void videoWriterThread() {
+    std::vector<unsigned char> yuv;
+    for (;;) {
+        unsigned tail = video.tail.load(std::memory_order_relaxed);
+        if (tail == video.head.load(std::memory_order_acquire)) {
+            if (video.finishing.load()) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        TRACE_SCOPE("video: gravar quadro");
+        const std::vector<unsigned char>& frame = video.frames[tail % VIDEO_QUEUE];
+        if (video.pipe) fwrite(frame.data(), 1, frame.size(), video.out);
+        else writeY4MFrame(video.out, frame.data(), video.width, video.height, yuv);
+        video.tail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+// Janela fechada durante a gravação: sem contexto GL, grava só o que já está na fila
+void finishVideoAtExit() {
+    if (!video.active) return;
+    video.finishing = true;
+    video.writer.join();
+    if (video.pipe) pclose(video.out);
+    else fclose(video.out);
+    video.active = false;
+}
+
+bool startVideo() {
+    video.started = true;
+    video.width = winWidth & ~1;            // 4:2:0 exige dimensões pares
+    video.height = winHeight & ~1;
+    size_t len = strlen(video.path);
+    bool y4m = len > 4 && strcmp(video.path + len - 4, ".y4m") == 0;
+    if (y4m) {
+        video.out = fopen(video.path, "wb");
+        if (video.out)
+            fprintf(video.out, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", video.width, video.height, video.fps);
+    } else {
+        char cmd[1024];
+        snprintf(cmd, sizeof(cmd), "ffmpeg -y -loglevel error -f rawvideo -pix_fmt rgba -s %dx%d -r %d -i - "
+                 "-vf vflip -pix_fmt yuv420p \"%s\"", video.width, video.height, video.fps, video.path);
+        video.out = popen(cmd, "w");
+        video.pipe = true;
+    }
+    if (!video.out) { printf("Erro ao abrir saida de video: %s\n", video.path); return false; }
+
+    size_t frameBytes = (size_t)video.width * video.height * 4;
+    glGenBuffers(VIDEO_PBOS, video.pbo);
+    for (int i = 0; i < VIDEO_PBOS; ++i) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, video.pbo[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    for (int i = 0; i < VIDEO_QUEUE; ++i) video.frames[i].resize(frameBytes);
+    video.writer = std::thread(videoWriterThread);
+    video.active = true;
+    atexit(finishVideoAtExit);
+    printf("Gravando video: %s (%dx%d, %d fps)\n", video.path, video.width, video.height, video.fps);
+    return true;
+}
+
+// Mapeia a leitura mais antiga do anel e a coloca na fila da escritora
+void videoDrainOldest() {
+    int slot = (int)(video.framesRead % VIDEO_PBOS);
+    unsigned head = video.head.load(std::memory_order_relaxed);
+    while (head - video.tail.load(std::memory_order_acquire) >= (unsigned)VIDEO_QUEUE)
+        std::this_thread::yield();                      // fila cheia: espera a escritora (sem perder quadros)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, video.pbo[slot]);
+    const void* src = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (src) {
+        std::vector<unsigned char>& dst = video.frames[head % VIDEO_QUEUE];
+        memcpy(dst.data(), src, dst.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        video.head.store(head + 1, std::memory_order_release);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    video.framesRead++;
+    video.pboFilled--;
+}
+
+void stopVideo() {
+    if (!video.active) return;
+    while (video.pboFilled > 0) videoDrainOldest();
+    video.finishing = true;
+    video.writer.join();
+    if (video.pipe) pclose(video.out);
+    else fclose(video.out);
+    glDeleteBuffers(VIDEO_PBOS, video.pbo);
+    video.active = false;
+    printf("Video salvo: %s (%ld quadros)\n", video.path, video.framesCaptured);
+}
+
+// Chamado após desenhar o quadro (antes do swap): leitura assíncrona para o
+// anel, entrega do quadro mais antigo e avanço da simulação em 1/fps segundos
+void captureVideoFrame() {
+    if (!video.active) return;
+    TRACE_SCOPE("video: captura");
+    if (winWidth < video.width || winHeight < video.height) {
+        printf("Janela redimensionada durante a gravacao; encerrando o video\n");
+        stopVideo();
+        return;
+    }
+    if (video.pboFilled == VIDEO_PBOS) videoDrainOldest();
+    int slot = (int)((video.framesRead + video.pboFilled) % VIDEO_PBOS);
+    glReadBuffer(GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, video.pbo[slot]);
+    glReadPixels(0, 0, video.width, video.height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    video.pboFilled++;
+    video.framesCaptured++;
+
+    video.stepAccum += 60.0 / video.fps;            // update() roda a 60 ticks por segundo
+    while (video.stepAccum >= 1.0) {
+        simulationTick();
+        video.stepAccum -= 1.0;
+    }
+    if (video.maxFrames && video.framesCaptured >= video.maxFrames) {
+        stopVideo();
+        exit(0);
+    }
+}
+
+// Tecla 'V': inicia/encerra a gravação (video.y4m se --video não foi passado)
+void toggleVideo() {
+    if (video.active) { stopVideo(); return; }
+    if (!video.path) video.path = "video.y4m";
+    video.finishing = false;
+    video.head = video.tail = 0;
+    video.framesRead = video.framesCaptured = 0;
+    video.pboFilled = 0;
+    startVideo();
+}
+
+void videoIdle() {
+    if (video.active) glutPostRedisplay();     // quadros o mais rápido possível, tempo pelo vídeo
+}
@@ -0,0 +1,40 @@
+// Gravação de vídeo (Y4M ou ffmpeg) a partir de um anel de PBOs
+#ifndef SOLAR_VIDEO_H
+#define SOLAR_VIDEO_H
+
+#include "common.h"
+#include <thread>
+#include <atomic>
+
+const int VIDEO_PBOS  = 3;
+const int VIDEO_QUEUE = 8;              // quadros em trânsito até a escritora
+
+struct VideoRecorder {
+    bool active = false;
+    const char* path = NULL;            // --video=arquivo (.y4m ou qualquer formato do ffmpeg)
+    int fps = 60;                       // --video-fps=N
+    long maxFrames = 0;                 // --video-frames=N (0 = até a tecla 'V' ou fechar)
+    int width = 0, height = 0;
+    GLuint pbo[VIDEO_PBOS];
+    int pboFilled = 0;                  // leituras em andamento no anel
+    long framesRead = 0, framesCaptured = 0;
+    double stepAccum = 0.0;             // ticks de simulação devidos (60 ticks/s)
+
+    // fila SPSC: slots [tail, head) prontos para a escritora
+    std::vector<unsigned char> frames[VIDEO_QUEUE];
+    std::atomic<unsigned> head{0}, tail{0};
+    std::atomic<bool> finishing{false};
+    std::thread writer;
+    FILE* out = NULL;
+    bool pipe = false;                  // out veio de popen (ffmpeg)
+    bool started = false;
+};
+
+extern VideoRecorder video;
+
+bool startVideo();
+void captureVideoFrame();
+void toggleVideo();
+void videoIdle();
+
+#endif
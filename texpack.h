@@ -0,0 +1,66 @@
+// Formato do pacote de texturas (textures.pack)
+// Compartilhado entre o empacotador (packer.cpp) e o programa (src/texture.cpp).
+//
+// Layout do arquivo:
+//   PackHeader
+//   PackEntry[count]            (índice)
+//   dados dos mips              (cada mip alinhado em PACK_ALIGN bytes)
+#ifndef TEXPACK_H
+#define TEXPACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+const uint32_t PACK_MAGIC    = 0x4B505353;  // "SSPK"
+const uint32_t PACK_VERSION  = 1;
+const uint32_t PACK_ALIGN    = 4096;        // alinhamento de página (mmap / upload direto)
+const int      PACK_MAX_MIPS = 16;
+const uint32_t PACK_MAX_SIZE = 1u << (PACK_MAX_MIPS - 1);   // 16384: mip 0 cabe na cadeia e w*h*4 em 32 bits
+
+enum PackFormat {
+    PACK_RGBA8 = 0,     // RGBA 8 bits por canal, sem compressão
+    PACK_DXT1  = 1      // S3TC DXT1 (blocos 4x4, 8 bytes por bloco)
+};
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;          // número de texturas no índice
+    uint32_t reserved;
+    uint64_t indexChecksum;  // checksum do índice (PackEntry[count])
+};
+
+struct PackEntry {
+    char     name[32];                  // nome da textura (ex.: "earth")
+    uint32_t width, height;             // tamanho do mip 0
+    uint32_t format;                    // PackFormat
+    uint32_t mipCount;                  // quantidade de níveis na cadeia
+    uint64_t checksum;                  // checksum de todos os mips
+    uint64_t mipOffset[PACK_MAX_MIPS];  // deslocamento de cada mip desde o início do arquivo
+    uint32_t mipSize[PACK_MAX_MIPS];    // tamanho em bytes de cada mip
+};
+
+// Checksum rápido (FNV-1a sobre palavras de 64 bits + bytes finais).
+inline uint64_t packChecksum(const void* data, size_t size, uint64_t h = 0xcbf29ce484222325ULL) {
+    const uint64_t prime = 0x100000001b3ULL;
+    const unsigned char* p = (const unsigned char*)data;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w;
+        __builtin_memcpy(&w, p + i * 8, 8);
+        h = (h ^ w) * prime;
+    }
+    for (size_t i = words * 8; i < size; ++i)
+        h = (h ^ p[i]) * prime;
+    return h;
+}
+
+// Tamanho em bytes de um mip w x h no formato dado (o packer grava e o
+// programa confere o índice com esta mesma conta).
+inline uint32_t packMipSize(uint32_t format, uint32_t w, uint32_t h) {
+    if (format == PACK_DXT1)
+        return ((w + 3) / 4) * ((h + 3) / 4) * 8;
+    return w * h * 4;
+}
+
+#endif